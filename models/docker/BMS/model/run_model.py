@@ -25,6 +25,7 @@ if __name__ == "__main__":
     whitening = options.get('whitening', True)
 
     max_dim = options.get('max_dim', 400)
+    tile_size = options.get('tile_size', 0)
 
     whitening = 1 if whitening else 0
 
@@ -42,7 +43,7 @@ if __name__ == "__main__":
         command = [
             "./build/BMS", image_path, output_path, sample_step,
             dilation_width_1, dilation_width_2, blur_std, colorspace,
-            whitening, max_dim
+            whitening, max_dim, tile_size
         ]
         command = list(map(str, command))
         rc = subprocess.call(command)
@@ -33,7 +33,7 @@ using namespace std;
 #define COV_MAT_REG 50.0f
 
 BMS::BMS(const Mat& src, int dw1, bool nm, bool hb, int colorSpace, bool whitening)
-:mDilationWidth_1(dw1), mNormalize(nm), mHandleBorder(hb), mAttMapCount(0), mColorSpace(colorSpace), mWhitening(whitening)
+:mDilationWidth_1(dw1), mNormalize(nm), mHandleBorder(hb), mAttMapCount(0), mSkippedThreshCount(0), mColorSpace(colorSpace), mWhitening(whitening)
 {
 	mSrc=src.clone();
 	mSaliencyMap = Mat::zeros(src.size(), CV_32FC1);
@@ -55,20 +55,55 @@ BMS::BMS(const Mat& src, int dw1, bool nm, bool hb, int colorSpace, bool whiteni
 	}
 }
 
+/* above[l] = number of pixels of an 8-bit map whose value is greater than l */
+void countPixelsAbove(const Mat& fm, vector<int>& above)
+{
+	assert(fm.type() == CV_8UC1);
+	vector<int> hist(256, 0);
+	for (int r=0;r<fm.rows;r++)
+	{
+		const uchar* p = fm.ptr<uchar>(r);
+		for (int c=0;c<fm.cols;c++)
+			hist[p[c]]++;
+	}
+	above.assign(256, 0);
+	for (int l=254;l>=0;l--)
+		above[l] = above[l+1] + hist[l+1];
+}
+
 void BMS::computeSaliency(double step)
 {
 	double max_,min_;
+	vector<int> above;
 	for (int i=0;i<mFeatureMaps.size();++i)
 	{
-		Mat bm;
+		Mat bm, am;
 		minMaxLoc(mFeatureMaps[i],&min_,&max_);
+		countPixelsAbove(mFeatureMaps[i], above);
+		const int total = mFeatureMaps[i].rows*mFeatureMaps[i].cols;
+		int lastAbove = -1;
 		for (double thresh = min_; thresh < max_; thresh += step)
 		{
+			/* the boolean map only changes when a grey level is crossed */
+			int nAbove = above[(int)thresh];
+			if (nAbove == 0 || nAbove == total)
+			{
+				/* empty or full map: nothing is surrounded */
+				mSkippedThreshCount++;
+				continue;
+			}
+			if (nAbove == lastAbove)
+			{
+				/* same boolean map as the previous threshold */
+				mSaliencyMap += am;
+				mSkippedThreshCount++;
+				continue;
+			}
 			bm=mFeatureMaps[i]>thresh;
-			Mat am = getAttentionMap(bm, mDilationWidth_1, mNormalize, mHandleBorder);
+			am = getAttentionMap(bm, mDilationWidth_1, mNormalize, mHandleBorder);
 			mSaliencyMap += am;
 			mAttMapCount++;
-
+			lastAbove = nAbove;
 		}
 	}
 
@@ -142,6 +177,11 @@ cv::Mat BMS::getAttentionMap(const cv::Mat& bm, int dilation_width_1, bool toNor
 	return map1+map2;
 }
 
+int BMS::getSkippedThresholdCount() const
+{
+	return mSkippedThreshCount;
+}
+
 Mat BMS::getSaliencyMap()
 {
 	Mat ret;
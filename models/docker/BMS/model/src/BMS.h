@@ -43,9 +43,11 @@ public:
 	BMS (const cv::Mat& src, int dw1, bool nm, bool hb, int colorSpace, bool whitening);
 	cv::Mat getSaliencyMap();
 	void computeSaliency(double step);
+	int getSkippedThresholdCount() const;
 private:
 	cv::Mat mSaliencyMap;
 	int mAttMapCount;
+	int mSkippedThreshCount;
 	cv::Mat mBorderPriorMap;
 	cv::Mat mSrc;
 	std::vector<cv::Mat> mFeatureMaps;
@@ -61,6 +63,7 @@ private:
 
 void postProcessByRec8u(cv::Mat& salmap, int kernelWidth);
 void postProcessByRec(cv::Mat& salmap, int kernelWidth);
+void countPixelsAbove(const cv::Mat& fm, std::vector<int>& above);
 
 
 
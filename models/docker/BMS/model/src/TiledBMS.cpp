@@ -0,0 +1,473 @@
+/*****************************************************************************
+*	Tile-based variant of the Boolean Map Saliency (BMS) engine for images
+*	too large to be processed with full-size temporaries.
+*
+*	Based on "Exploit Surroundedness for Saliency Detection: A Boolean Map
+*	Approach", Jianming Zhang, Stan Sclaroff, submitted to PAMI, 2014
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "TiledBMS.h"
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+using namespace cv;
+using namespace std;
+
+#define COV_MAT_REG 50.0f
+
+/* labels the 8-connected components of both the true and the false pixels
+   of a boolean map; returns the number of labels (labels start at 1) */
+static int labelBooleanMap(const Mat& bm, Mat& lab)
+{
+	Mat labFg, labBg;
+	int nFg = connectedComponents(bm, labFg, 8, CV_32S);
+	Mat inv = ~bm;
+	int nBg = connectedComponents(inv, labBg, 8, CV_32S);
+	lab.create(bm.size(), CV_32SC1);
+	for (int y=0;y<bm.rows;y++)
+	{
+		const uchar* b = bm.ptr<uchar>(y);
+		const int* f = labFg.ptr<int>(y);
+		const int* g = labBg.ptr<int>(y);
+		int* l = lab.ptr<int>(y);
+		for (int x=0;x<bm.cols;x++)
+			l[x] = b[x] ? f[x] : nFg - 1 + g[x];
+	}
+	return nFg + nBg - 2;
+}
+
+TiledBMS::TiledBMS(const Mat& src, int dw1, bool nm, int colorSpace, bool whitening, int tileSize)
+:mSrc(src), mDilationWidth_1(dw1), mNormalize(nm), mColorSpace(colorSpace), mWhitening(whitening), mSkippedThreshCount(0)
+{
+	assert(src.type() == CV_8UC3);
+	mRingWidth = max(1, dw1);
+	mTileSize = max(tileSize, mRingWidth);
+
+	/* the last tile of a row/column absorbs the remainder, so no tile is
+	   narrower than the ring its neighbours read the halo from */
+	mTilesX = max(1, src.cols / mTileSize);
+	mTilesY = max(1, src.rows / mTileSize);
+	for (int ty=0;ty<mTilesY;ty++)
+	{
+		for (int tx=0;tx<mTilesX;tx++)
+		{
+			int x0 = tx*mTileSize, y0 = ty*mTileSize;
+			int x1 = (tx == mTilesX-1) ? src.cols : x0+mTileSize;
+			int y1 = (ty == mTilesY-1) ? src.rows : y0+mTileSize;
+			mTiles.push_back(Rect(x0, y0, x1-x0, y1-y0));
+		}
+	}
+	mRings.resize(mTiles.size());
+
+	mSaliencyMap = Mat::zeros(src.size(), CV_32FC1);
+	mFeatureMap.create(src.size(), CV_8UC1);
+	mMapBits.create(src.size(), CV_8UC1);
+}
+
+void TiledBMS::computeSaliency(double step)
+{
+	static const int colorSpaces[3] = {CL_RGB, CL_Lab, CL_Luv};
+	for (int s=0;s<3;s++)
+	{
+		if (!(mColorSpace & colorSpaces[s]))
+			continue;
+		if (mWhitening)
+			computeWhitening(colorSpaces[s]);
+		for (int ch=0;ch<3;ch++)
+		{
+			computeFeatureMap(colorSpaces[s], ch);
+			sweepThresholds(step);
+		}
+	}
+}
+
+Mat TiledBMS::getSaliencyMap()
+{
+	double max_,min_;
+	minMaxLoc(mSaliencyMap,&min_,&max_);
+	double scale = max_ - min_ > DBL_EPSILON ? 255.0/(max_ - min_) : 0.0;
+	Mat ret;
+	mSaliencyMap.convertTo(ret, CV_8UC1, scale, -min_*scale);
+	return ret;
+}
+
+int TiledBMS::getSkippedThresholdCount() const
+{
+	return mSkippedThreshCount;
+}
+
+Rect TiledBMS::expandRect(const Rect& r, int margin) const
+{
+	int x0 = max(0, r.x - margin), y0 = max(0, r.y - margin);
+	int x1 = min(mSrc.cols, r.x + r.width + margin);
+	int y1 = min(mSrc.rows, r.y + r.height + margin);
+	return Rect(x0, y0, x1-x0, y1-y0);
+}
+
+Mat TiledBMS::colorTile(int colorSpace, const Rect& r) const
+{
+	Mat tile = mSrc(r);
+	if (colorSpace == CL_Lab)
+	{
+		Mat lab;
+		cvtColor(tile, lab, CV_RGB2Lab);
+		return lab;
+	}
+	if (colorSpace == CL_Luv)
+	{
+		Mat luv;
+		cvtColor(tile, luv, CV_RGB2Luv);
+		return luv;
+	}
+	return tile;
+}
+
+/* one channel of the (whitened) colour tile, before range normalization */
+Mat TiledBMS::rawFeatureTile(int colorSpace, int channel, const Rect& r) const
+{
+	Mat tile = colorTile(colorSpace, r);
+	if (!mWhitening)
+	{
+		vector<Mat> planes;
+		split(tile, planes);
+		return planes[channel];
+	}
+	Mat tileF;
+	tile.convertTo(tileF, CV_32FC3);
+	Mat raw = tileF.reshape(1, r.width*r.height) * mSqrtInvCov.col(channel);
+	return raw.reshape(1, r.height);
+}
+
+/* same whitening transform as BMS::whitenFeatMap, with the covariance
+   accumulated tile by tile */
+void TiledBMS::computeWhitening(int colorSpace)
+{
+	double s[3] = {0, 0, 0};
+	double ss[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+	for (size_t t=0;t<mTiles.size();t++)
+	{
+		Mat tile = colorTile(colorSpace, mTiles[t]);
+		for (int y=0;y<tile.rows;y++)
+		{
+			const uchar* p = tile.ptr<uchar>(y);
+			for (int x=0;x<tile.cols;x++, p+=3)
+			{
+				for (int i=0;i<3;i++)
+				{
+					s[i] += p[i];
+					for (int j=0;j<3;j++)
+						ss[i][j] += p[i]*p[j];
+				}
+			}
+		}
+	}
+
+	double n = (double)mSrc.rows*mSrc.cols;
+	Mat covF(3, 3, CV_32FC1);
+	for (int i=0;i<3;i++)
+		for (int j=0;j<3;j++)
+			covF.at<float>(i,j) = (float)(ss[i][j]/n - s[i]*s[j]/(n*n));
+
+	covF += Mat::eye(covF.rows, covF.cols, CV_32FC1)*COV_MAT_REG;
+	SVD svd(covF);
+	Mat sqrtW;
+	sqrt(svd.w,sqrtW);
+	mSqrtInvCov = svd.u * Mat::diag(1.0/sqrtW);
+}
+
+void TiledBMS::computeFeatureMap(int colorSpace, int channel)
+{
+	double max_ = -DBL_MAX, min_ = DBL_MAX;
+	for (size_t t=0;t<mTiles.size();t++)
+	{
+		double tmax, tmin;
+		minMaxLoc(rawFeatureTile(colorSpace, channel, mTiles[t]), &tmin, &tmax);
+		min_ = min(min_, tmin);
+		max_ = max(max_, tmax);
+	}
+	double scale = max_ - min_ > DBL_EPSILON ? 255.0/(max_ - min_) : 0.0;
+
+	/* one pixel of halo for the 3x3 median */
+	for (size_t t=0;t<mTiles.size();t++)
+	{
+		const Rect& r = mTiles[t];
+		Rect e = expandRect(r, 1);
+		Mat fm;
+		rawFeatureTile(colorSpace, channel, e).convertTo(fm, CV_8U, scale, -min_*scale);
+		medianBlur(fm, fm, 3);
+		Mat dst = mFeatureMap(r);
+		fm(Rect(r.x - e.x, r.y - e.y, r.width, r.height)).copyTo(dst);
+	}
+}
+
+void TiledBMS::sweepThresholds(double step)
+{
+	double max_,min_;
+	minMaxLoc(mFeatureMap,&min_,&max_);
+	vector<int> above;
+	countPixelsAbove(mFeatureMap, above);
+	const int total = mFeatureMap.rows*mFeatureMap.cols;
+	int lastAbove = -1;
+	float w1 = 0, w2 = 0;
+	for (double thresh = min_; thresh < max_; thresh += step)
+	{
+		int nAbove = above[(int)thresh];
+		if (nAbove == 0 || nAbove == total)
+		{
+			mSkippedThreshCount++;
+			continue;
+		}
+		if (nAbove == lastAbove)
+		{
+			mSkippedThreshCount++;
+		}
+		else
+		{
+			int n1, n2;
+			computeAttentionBits(thresh, n1, n2);
+			/* L2 normalization of a binary map scales every set pixel by
+			   1/sqrt(count); unnormalized maps are 0/255 */
+			if (mNormalize)
+			{
+				w1 = n1 > 0 ? (float)(1.0/sqrt((double)n1)) : 0.f;
+				w2 = n2 > 0 ? (float)(1.0/sqrt((double)n2)) : 0.f;
+			}
+			else
+				w1 = w2 = 255.f;
+			lastAbove = nAbove;
+		}
+		accumulateBits(w1, w2);
+	}
+}
+
+void TiledBMS::computeAttentionBits(double thresh, int& n1, int& n2)
+{
+	mParent.clear();
+	mOpen.clear();
+	mNodeValue.clear();
+	for (int t=0;t<(int)mTiles.size();t++)
+		linkTile(t, thresh);
+	for (int i=0;i<(int)mParent.size();i++)
+		if (mOpen[i])
+			mOpen[findRoot(i)] = 1;
+
+	n1 = n2 = 0;
+	for (int t=0;t<(int)mTiles.size();t++)
+		markTile(t, thresh, n1, n2);
+}
+
+/* first pass: label the tile, record its edge rings and join them with the
+   rings of the neighbours already visited (left, top-left, top, top-right) */
+void TiledBMS::linkTile(int t, double thresh)
+{
+	const Rect& r = mTiles[t];
+	Mat bm = mFeatureMap(r) > thresh;
+	Mat lab;
+	int nLab = labelBooleanMap(bm, lab);
+
+	vector<int> node(nLab+1, -1);
+	int rw = min(mRingWidth, r.width), rh = min(mRingWidth, r.height);
+	TileRing& ring = mRings[t];
+	ring.top = ringNodes(lab, bm, Rect(0, 0, r.width, rh), node);
+	ring.bottom = ringNodes(lab, bm, Rect(0, r.height-rh, r.width, rh), node);
+	ring.left = ringNodes(lab, bm, Rect(0, 0, rw, r.height), node);
+	ring.right = ringNodes(lab, bm, Rect(r.width-rw, 0, rw, r.height), node);
+
+	/* components touching the image border are never surrounded */
+	if (r.y == 0)
+		for (int x=0;x<r.width;x++)
+			mOpen[ring.top.at<int>(0,x)] = 1;
+	if (r.y + r.height == mSrc.rows)
+		for (int x=0;x<r.width;x++)
+			mOpen[ring.bottom.at<int>(rh-1,x)] = 1;
+	if (r.x == 0)
+		for (int y=0;y<r.height;y++)
+			mOpen[ring.left.at<int>(y,0)] = 1;
+	if (r.x + r.width == mSrc.cols)
+		for (int y=0;y<r.height;y++)
+			mOpen[ring.right.at<int>(y,rw-1)] = 1;
+
+	int tx = t % mTilesX, ty = t / mTilesX;
+	if (tx > 0)
+	{
+		const Mat& nb = mRings[t-1].right;
+		for (int y=0;y<r.height;y++)
+			for (int yy=max(0,y-1);yy<=min(r.height-1,y+1);yy++)
+				join(ring.left.at<int>(y,0), nb.at<int>(yy,nb.cols-1));
+	}
+	if (ty > 0)
+	{
+		const Mat& nb = mRings[t-mTilesX].bottom;
+		for (int x=0;x<r.width;x++)
+			for (int xx=max(0,x-1);xx<=min(r.width-1,x+1);xx++)
+				join(ring.top.at<int>(0,x), nb.at<int>(nb.rows-1,xx));
+	}
+	if (tx > 0 && ty > 0)
+	{
+		const Mat& nb = mRings[t-mTilesX-1].bottom;
+		join(ring.top.at<int>(0,0), nb.at<int>(nb.rows-1,nb.cols-1));
+	}
+	if (tx < mTilesX-1 && ty > 0)
+	{
+		const Mat& nb = mRings[t-mTilesX+1].bottom;
+		join(ring.top.at<int>(0,r.width-1), nb.at<int>(nb.rows-1,0));
+	}
+}
+
+/* second pass: surroundedness of the tile and its halo, dilation, and the
+   attention map bits of the tile */
+void TiledBMS::markTile(int t, double thresh, int& n1, int& n2)
+{
+	const Rect& r = mTiles[t];
+	Rect e = expandRect(r, mDilationWidth_1);
+	Rect core(r.x - e.x, r.y - e.y, r.width, r.height);
+	Mat bm = mFeatureMap(e) > thresh;
+	Mat lab;
+	int nLab = labelBooleanMap(bm(core), lab);
+
+	/* the labelling is the same as in linkTile, so the rings give the
+	   union-find node of every label that reaches a tile edge */
+	vector<int> node(nLab+1, -1);
+	const TileRing& ring = mRings[t];
+	const Mat* strips[4] = {&ring.top, &ring.bottom, &ring.left, &ring.right};
+	const Point origins[4] = {Point(0, 0), Point(0, r.height-ring.bottom.rows),
+		Point(0, 0), Point(r.width-ring.right.cols, 0)};
+	for (int k=0;k<4;k++)
+	{
+		const Mat& s = *strips[k];
+		for (int y=0;y<s.rows;y++)
+			for (int x=0;x<s.cols;x++)
+				node[lab.at<int>(origins[k].y+y, origins[k].x+x)] = s.at<int>(y,x);
+	}
+	/* components that do not reach a tile edge cannot reach the image border */
+	vector<uchar> surrounded(nLab+1);
+	for (int l=1;l<=nLab;l++)
+		surrounded[l] = node[l] < 0 || !mOpen[findRoot(node[l])];
+
+	Mat sur(e.size(), CV_8UC1);
+	for (int y=0;y<e.height;y++)
+	{
+		uchar* s = sur.ptr<uchar>(y);
+		for (int x=0;x<e.width;x++)
+		{
+			bool in = core.contains(Point(x, y));
+			bool isSur = in ? surrounded[lab.at<int>(y-core.y, x-core.x)] != 0
+				: !mOpen[findRoot(ringNodeAt(e.x+x, e.y+y))];
+			s[x] = isSur ? 255 : 0;
+		}
+	}
+
+	Mat map1, map2;
+	map1 = sur & bm;
+	map2 = sur & (~bm);
+
+	if (mDilationWidth_1 > 0)
+	{
+		dilate(map1, map1, Mat(), Point(-1, -1), mDilationWidth_1);
+		dilate(map2, map2, Mat(), Point(-1, -1), mDilationWidth_1);
+	}
+
+	Mat bits = mMapBits(r);
+	for (int y=0;y<r.height;y++)
+	{
+		const uchar* m1 = map1.ptr<uchar>(core.y+y) + core.x;
+		const uchar* m2 = map2.ptr<uchar>(core.y+y) + core.x;
+		uchar* b = bits.ptr<uchar>(y);
+		for (int x=0;x<r.width;x++)
+		{
+			b[x] = (m1[x] ? 1 : 0) | (m2[x] ? 2 : 0);
+			n1 += m1[x] ? 1 : 0;
+			n2 += m2[x] ? 1 : 0;
+		}
+	}
+}
+
+void TiledBMS::accumulateBits(float w1, float w2)
+{
+	const float lut[4] = {0.f, w1, w2, w1 + w2};
+	for (int y=0;y<mSaliencyMap.rows;y++)
+	{
+		const uchar* b = mMapBits.ptr<uchar>(y);
+		float* s = mSaliencyMap.ptr<float>(y);
+		for (int x=0;x<mSaliencyMap.cols;x++)
+			s[x] += lut[b[x]];
+	}
+}
+
+/* assigns a union-find node to every label seen in the strip r of the tile */
+Mat TiledBMS::ringNodes(const Mat& lab, const Mat& bm, const Rect& r, vector<int>& node)
+{
+	Mat strip(r.size(), CV_32SC1);
+	for (int y=0;y<r.height;y++)
+	{
+		for (int x=0;x<r.width;x++)
+		{
+			int l = lab.at<int>(r.y+y, r.x+x);
+			if (node[l] < 0)
+			{
+				node[l] = (int)mParent.size();
+				mParent.push_back(node[l]);
+				mOpen.push_back(0);
+				mNodeValue.push_back(bm.at<uchar>(r.y+y, r.x+x));
+			}
+			strip.at<int>(y,x) = node[l];
+		}
+	}
+	return strip;
+}
+
+/* union-find node of an image pixel lying in the edge ring of its tile */
+int TiledBMS::ringNodeAt(int x, int y) const
+{
+	int tx = min(x / mTileSize, mTilesX-1);
+	int ty = min(y / mTileSize, mTilesY-1);
+	int t = ty*mTilesX + tx;
+	const Rect& r = mTiles[t];
+	const TileRing& ring = mRings[t];
+	int lx = x - r.x, ly = y - r.y;
+	if (ly < ring.top.rows)
+		return ring.top.at<int>(ly, lx);
+	if (ly >= r.height - ring.bottom.rows)
+		return ring.bottom.at<int>(ly - (r.height - ring.bottom.rows), lx);
+	if (lx < ring.left.cols)
+		return ring.left.at<int>(ly, lx);
+	assert(lx >= r.width - ring.right.cols);
+	return ring.right.at<int>(ly, lx - (r.width - ring.right.cols));
+}
+
+int TiledBMS::findRoot(int i)
+{
+	while (mParent[i] != i)
+	{
+		mParent[i] = mParent[mParent[i]];
+		i = mParent[i];
+	}
+	return i;
+}
+
+/* joins two 8-adjacent pixels' components if they have the same value */
+void TiledBMS::join(int a, int b)
+{
+	if (mNodeValue[a] != mNodeValue[b])
+		return;
+	a = findRoot(a);
+	b = findRoot(b);
+	if (a != b)
+		mParent[max(a, b)] = min(a, b);
+}
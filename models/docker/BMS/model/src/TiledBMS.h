@@ -0,0 +1,92 @@
+/*****************************************************************************
+*	Tile-based variant of the Boolean Map Saliency (BMS) engine for images
+*	too large to be processed with full-size temporaries.
+*
+*	Based on "Exploit Surroundedness for Saliency Detection: A Boolean Map
+*	Approach", Jianming Zhang, Stan Sclaroff, submitted to PAMI, 2014
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef TILED_BMS_H
+#define TILED_BMS_H
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "BMS.h"
+
+/*
+*	Computes the same saliency map as BMS (without border handling), but
+*	walks the image in tiles. Whitening statistics, feature map ranges and
+*	the surroundedness of every boolean map are global: components are
+*	labelled per tile, and the components touching a tile edge are joined
+*	across the seams with a union-find. The dilation reads a halo from the
+*	neighbouring tiles' edge rings.
+*
+*	Float and label temporaries are allocated per tile. Besides the input
+*	and the float accumulator only two 8-bit planes (the current feature
+*	map and the attention map bits of the current threshold) are kept at
+*	full size.
+*/
+class TiledBMS
+{
+public:
+	TiledBMS (const cv::Mat& src, int dw1, bool nm, int colorSpace, bool whitening, int tileSize);
+	cv::Mat getSaliencyMap();
+	void computeSaliency(double step);
+	int getSkippedThresholdCount() const;
+private:
+	/* union-find node ids of the pixels within mRingWidth of a tile edge */
+	struct TileRing
+	{
+		cv::Mat top, bottom, left, right;
+	};
+
+	cv::Mat mSrc;
+	cv::Mat mSaliencyMap;
+	cv::Mat mFeatureMap;
+	cv::Mat mMapBits;
+	cv::Mat mSqrtInvCov;
+	int mDilationWidth_1;
+	bool mNormalize;
+	int mColorSpace;
+	bool mWhitening;
+	int mSkippedThreshCount;
+	int mTileSize;
+	int mTilesX, mTilesY;
+	int mRingWidth;
+	std::vector<cv::Rect> mTiles;
+	std::vector<TileRing> mRings;
+	std::vector<int> mParent;
+	std::vector<uchar> mOpen;
+	std::vector<uchar> mNodeValue;
+
+	cv::Rect expandRect(const cv::Rect& r, int margin) const;
+	cv::Mat colorTile(int colorSpace, const cv::Rect& r) const;
+	cv::Mat rawFeatureTile(int colorSpace, int channel, const cv::Rect& r) const;
+	void computeWhitening(int colorSpace);
+	void computeFeatureMap(int colorSpace, int channel);
+	void sweepThresholds(double step);
+	void computeAttentionBits(double thresh, int& n1, int& n2);
+	void linkTile(int t, double thresh);
+	void markTile(int t, double thresh, int& n1, int& n2);
+	void accumulateBits(float w1, float w2);
+	cv::Mat ringNodes(const cv::Mat& lab, const cv::Mat& bm, const cv::Rect& r, std::vector<int>& node);
+	int ringNodeAt(int x, int y) const;
+	int findRoot(int i);
+	void join(int a, int b);
+};
+
+#endif
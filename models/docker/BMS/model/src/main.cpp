@@ -26,6 +26,7 @@
 
 #include "opencv2/opencv.hpp"
 #include "BMS.h"
+#include "TiledBMS.h"
 #include "fileGettor.h"
 
 #define MAX_IMG_DIM 400
@@ -37,7 +38,12 @@ void help() {
   cout << "Usage: \n"
        << "BMS <input_path> <output_path> <step_size> <dilation_width1> "
           "<dilation_width2> <blurring_std> <color_space> <whitening> "
-          "<max_dim>\n"
+          "[max_dim] [tile_size]\n"
+       << "  max_dim: longer side the image is resized to (default "
+       << MAX_IMG_DIM << ", 0 keeps the native resolution)\n"
+       << "  tile_size: if > 0, process the image in tiles of this size to "
+          "bound memory on large images (tiles never use border handling, "
+          "which this tool always leaves off)\n"
        << "Press ENTER to continue ..." << endl;
   getchar();
 }
@@ -45,7 +51,7 @@ void help() {
 void doWork(const string& in_path, const string& out_path, int sample_step,
             int dilation_width_1, int dilation_width_2, float blur_std,
             bool use_normalize, bool handle_border, int colorSpace,
-            bool whitening, float max_dimension) {
+            bool whitening, float max_dimension, int tile_size) {
   // TODO: FIXME hack to get working in the context of SMILER. part 1/3.
   // if (in_path.compare(out_path) == 0)
   //   cerr << "output path must be different from input path!" << endl;
@@ -74,7 +80,9 @@ void doWork(const string& in_path, const string& out_path, int sample_step,
     Mat src_small;
     float w = (float)src.cols, h = (float)src.rows;
     float maxD = max(w, h);
-    if (max_dimension < 0)
+    if (max_dimension == 0)
+      src_small = src;
+    else if (max_dimension < 0)
       resize(src, src_small,
              Size((int)(MAX_IMG_DIM * w / maxD), (int)(MAX_IMG_DIM * h / maxD)),
              0.0, 0.0, INTER_AREA);  // standard: width: 600 pixel
@@ -86,11 +94,26 @@ void doWork(const string& in_path, const string& out_path, int sample_step,
     /* Computing saliency */
     ttt = clock();
 
-    BMS bms(src_small, dilation_width_1, use_normalize, handle_border,
-            colorSpace, whitening);
-    bms.computeSaliency((double)sample_step);
-
-    Mat result = bms.getSaliencyMap();
+    Mat result;
+    int skipped_thresholds;
+    if (tile_size > 0) {
+      // the tiled engine never handles borders (as HANDLE_BORDER in main)
+      TiledBMS bms(src_small, dilation_width_1, use_normalize, colorSpace,
+                   whitening, tile_size);
+      bms.computeSaliency((double)sample_step);
+      result = bms.getSaliencyMap();
+      skipped_thresholds = bms.getSkippedThresholdCount();
+    } else {
+      BMS bms(src_small, dilation_width_1, use_normalize, handle_border,
+              colorSpace, whitening);
+      bms.computeSaliency((double)sample_step);
+      result = bms.getSaliencyMap();
+      skipped_thresholds = bms.getSkippedThresholdCount();
+    }
+    // diagnostics go to stderr; the runner only reads the saliency map
+    cerr << file_list[i] << ": " << skipped_thresholds
+         << " thresholds skipped (empty, full or unchanged boolean map)"
+         << endl;
 
     /* Post-processing */
 
@@ -143,9 +166,12 @@ int main(int args, char** argv) {
   float MAX_DIM = -1.0f;
   if (args > 9) MAX_DIM = (float)atof(argv[9]);
 
+  int TILE_SIZE = 0;  // 0: process the whole image at once
+  if (args > 10) TILE_SIZE = atoi(argv[10]);
+
   doWork(INPUT_PATH, OUTPUT_PATH, SAMPLE_STEP, DILATION_WIDTH_1,
          DILATION_WIDTH_2, BLUR_STD, NORMALIZE, HANDLE_BORDER, COLORSPACE,
-         WHITENING, MAX_DIM);
+         WHITENING, MAX_DIM, TILE_SIZE);
 
   return 0;
 }
@@ -0,0 +1,112 @@
+/*****************************************************************************
+*	Checks that TiledBMS computes the saliency map of BMS (without border
+*	handling) on images that span several tiles.
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include <iostream>
+
+#include "opencv2/opencv.hpp"
+#include "BMS.h"
+#include "TiledBMS.h"
+
+using namespace cv;
+using namespace std;
+
+// A test image whose regions cross the tile seams: a colour gradient with
+// noise, rings that surround regions of other colours (surroundedness must
+// be joined across the seams), random blobs, and a bar that touches the image
+// border (never surrounded)
+static Mat testImage(int rows, int cols) {
+  Mat img(rows, cols, CV_8UC3);
+  for (int y = 0; y < rows; y++)
+    for (int x = 0; x < cols; x++)
+      img.at<Vec3b>(y, x) = Vec3b((uchar)(40 + 100 * x / cols),
+                                  (uchar)(60 + 80 * y / rows), 90);
+  RNG rng(12345);
+  Mat noise(rows, cols, CV_8UC3);
+  rng.fill(noise, RNG::UNIFORM, Scalar::all(0), Scalar::all(12));
+  img += noise;
+
+  circle(img, Point(cols / 2, rows / 2), min(rows, cols) / 3,
+         Scalar(20, 200, 240), 9);
+  circle(img, Point(cols / 2, rows / 2), min(rows, cols) / 6,
+         Scalar(230, 40, 30), -1);
+  rectangle(img, Point(cols / 8, rows / 8), Point(cols / 3, rows / 2),
+            Scalar(250, 250, 250), 5);
+  for (int i = 0; i < 12; i++) {
+    Point c(rng.uniform(0, cols), rng.uniform(0, rows));
+    circle(img, c, rng.uniform(3, 15),
+           Scalar(rng.uniform(0, 256), rng.uniform(0, 256),
+                  rng.uniform(0, 256)),
+           -1);
+  }
+  rectangle(img, Point(0, rows - rows / 6), Point(cols / 2, rows - 1),
+            Scalar(10, 10, 10), -1);
+  return img;
+}
+
+// compares the 8-bit maps of BMS and TiledBMS. Without whitening the feature
+// maps of both are the same, and the maps may only differ by the rounding of
+// the float sums (1 level). With whitening, the covariance is summed tile by
+// tile, which may move single pixels across a grey level of a feature map
+static bool check(const Mat& img, int tileSize, int colorSpace,
+                  bool whitening) {
+  const int dw1 = 3, step = 8;
+  BMS bms(img, dw1, true, false, colorSpace, whitening);
+  bms.computeSaliency(step);
+  Mat reference = bms.getSaliencyMap();
+  TiledBMS tiled(img, dw1, true, colorSpace, whitening, tileSize);
+  tiled.computeSaliency(step);
+  Mat result = tiled.getSaliencyMap();
+
+  Mat diff;
+  absdiff(reference, result, diff);
+  double maxDiff;
+  minMaxLoc(diff, 0, &maxDiff);
+  const double meanDiff = mean(diff)[0];
+  const double fracOver2 =
+      (double)countNonZero(diff > 2) / (diff.rows * diff.cols);
+  bool ok;
+  if (whitening)
+    ok = meanDiff <= 1.0 && fracOver2 <= 0.005;
+  else
+    ok = maxDiff <= 1 && bms.getSkippedThresholdCount() ==
+                             tiled.getSkippedThresholdCount();
+
+  cout << (ok ? "ok   " : "FAIL ") << img.rows << "x" << img.cols
+       << " tile " << tileSize << " color space " << colorSpace
+       << (whitening ? " whitening" : "") << ": max. difference " << maxDiff
+       << ", mean " << meanDiff << ", > 2 at " << 100 * fracOver2
+       << "% of the pixels; skipped thresholds "
+       << bms.getSkippedThresholdCount() << " / "
+       << tiled.getSkippedThresholdCount() << endl;
+  return ok;
+}
+
+int main() {
+  // tile sizes that leave remainders (the last tile absorbs them), and one
+  // tile for the whole image
+  const int tileSizes[] = {24, 37, 64, 1000};
+  const int colorSpaces[] = {CL_RGB, CL_Lab, CL_RGB | CL_Lab};
+  Mat img = testImage(150, 203);
+  int failures = 0;
+  for (int t = 0; t < 4; t++)
+    for (int c = 0; c < 3; c++)
+      for (int w = 0; w < 2; w++)
+        if (!check(img, tileSizes[t], colorSpaces[c], w == 1))
+          failures++;
+  return failures ? 1 : 0;
+}
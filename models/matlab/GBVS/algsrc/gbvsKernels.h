@@ -0,0 +1,593 @@
+#ifndef GBVS_KERNELS_H
+#define GBVS_KERNELS_H
+
+#include <math.h>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Kernels behind the GBVS mex functions, shared with the native (MATLAB-free)
+// library in ../native. All arrays are column-major, as in MATLAB.
+//
+// Precision: the P x P matrices D and MM (TM in the templates) may be float
+// or double, and so may the maps of the O(P) kernels (T); the vectors of the
+// power iteration are always doubles. With float matrices the weights are
+// still computed, summed and multiplied in double, and only rounded when they
+// are stored: half the memory and memory traffic of the markov matrix, at a
+// relative error of about 1e-7 per entry. The mex functions pick the type
+// from the class (single or double) of their arguments.
+
+// Avalues = mexArrangeLinear( A , dims )
+// where A is the     NxM x K   matrix containing multi-resolution info
+//       dims is      K x 2     matrix containing dimensions of each scale
+//       Avalues is   P x 1 matrix containing multi-resolution info in flat array
+
+inline int arrangeLinearSize(const double *dims, int K) {
+  int i, P = 0;
+  for (i=0;i<K;i++)
+    P += (int)( dims[ i ] * dims[ K + i ] );
+  return P;
+}
+
+template <class T>
+inline void arrangeLinear(const T *A, const double *dims, int K, T *Avalues) {
+  int i,r,c,cur_index;
+  int N, M, offset_,M_orig,N_orig,mapsize, coffset;
+
+  M_orig = (int)dims[0];
+  N_orig = (int)dims[K];
+  mapsize = M_orig * N_orig;
+  offset_ = 0;
+  cur_index = 0;
+  for (i=0;i<K;i++) {
+    M = (int)dims[ i ];
+    N = (int)dims[ K + i ];
+    for (c=0;c<N;c++) {
+      coffset = offset_ + c*M_orig;
+      for (r=0;r<M;r++)
+	Avalues[cur_index++] = A[ coffset + r ];
+    }
+    offset_ += mapsize;
+  }
+}
+
+//  mexAssignWeights( AL , D , MM , algtype )
+//
+//  name      dim    description
+// -------------------------------------------
+//  AL        Px1    values of map linearized
+//  D         PxP    w=D(i,j)==D(j,i) is dist multiplier for i & j
+//  MM        PxP    output space for markov matrix
+//  algtype   1x1    algorith type:
+//                    1 : MM( i->j ) = w*AL(j)               [ mass conc ]
+//                    2 : MM( i->j ) = w*|AL(i)-AL(j)|       [ sal diff ]
+//                    3 : MM( i->j ) = w*|log(AL(i)/AL(j))|  [ sal log ]
+//                    4 : MM( i->j ) = w*1/|AL(i)-AL(j)|     [ sal affin ]
+
+inline double myabs(double v) {
+  return (v>=0) ? v : (-1*v);
+}
+
+// edge weight of algtype ALG (before the distance multiplier) from node c to
+// node r. The algtype is a template argument so that the inner loops are
+// specialized and branch-free; algtype 3 uses precomputed logs, since
+// |log(AL(r)/AL(c))| = |log(AL(r)) - log(AL(c))|.
+
+template <int ALG>
+inline double markovWeight(double ar, double ac, double lr, double lc) {
+  if ( ALG == 1 ) return ar;
+  if ( ALG == 2 ) return myabs( ar - ac );
+  if ( ALG == 3 ) return myabs( lr - lc );
+  return 1/(myabs( ar - ac )+1e-12);
+}
+
+// logs of AL for algtype 3 (AL itself otherwise, where they are not used)
+inline const double *markovLogs(const double *AL, int P, int algtype_i, std::vector<double>& buf) {
+  if ( algtype_i != 3 )
+    return AL;
+  buf.resize(P);
+  for (int i=0;i<P;i++) buf[i] = log( AL[i] );
+  return &buf[0];
+}
+
+template <int ALG, class TM>
+inline void assignWeightsT(const double *AL, const double *LAL, const TM *D, TM *MM, int P) {
+  int r, c;
+
+#pragma omp parallel for private(r) schedule(static)
+  for (c=0;c<P;c++) {
+    const TM *Dc = D + (size_t)P * c;
+    TM *MMc = MM + (size_t)P * c;
+    const double ac = AL[c], lc = LAL[c];
+    for (r=0;r<P;r++)
+      MMc[ r ] = (TM)( Dc[ r ] * markovWeight<ALG>( AL[r] , ac , LAL[r] , lc ) ); // D(r,c)
+  }
+}
+
+template <class TM>
+inline void assignWeights(const double *AL, const TM *D, TM *MM, int P, int algtype_i) {
+  std::vector<double> buf;
+  const double *LAL = markovLogs( AL , P , algtype_i , buf );
+  switch ( algtype_i ) {
+  case 1: assignWeightsT<1>( AL , LAL , D , MM , P ); break;
+  case 2: assignWeightsT<2>( AL , LAL , D , MM , P ); break;
+  case 3: assignWeightsT<3>( AL , LAL , D , MM , P ); break;
+  case 4: assignWeightsT<4>( AL , LAL , D , MM , P ); break;
+  }
+}
+
+// Normalizes so that each column sums to one
+
+template <class T>
+inline void columnNormalize(T *A, int numR, int numC) {
+  double s;
+  int i,j,myoff;
+
+#pragma omp parallel for private(i,s,myoff) schedule(static)
+  for (j=0;j<numC;j++) {
+    s = 0;
+    myoff = j*numR;
+    for (i=0;i<numR;i++)
+      s += A[ myoff + i ];
+    for (i=0;i<numR;i++)
+      A[ myoff + i ] = (T)( A[ myoff + i ] / s );
+  }
+}
+
+// Fused mexAssignWeights + mexColumnNormalize: each column is weighted and
+// summed in one pass and rescaled while it is still in cache, instead of
+// two full passes over the P x P matrix. If y is given, y = MM * x is
+// accumulated in the same pass (the first product of the power iteration).
+
+template <int ALG, class TM>
+inline void assignWeightsNormalizedT(const double *AL, const double *LAL, const TM *D, TM *MM, int P, const double *x, double *y) {
+  std::vector<double> ypart;
+
+#pragma omp parallel
+  {
+    int nt = 1, t = 0;
+#ifdef _OPENMP
+    nt = omp_get_num_threads();
+    t = omp_get_thread_num();
+#endif
+#pragma omp single
+    ypart.assign( y ? (size_t)nt * P : 0 , 0.0 );
+    double *ylocal = y ? &ypart[ (size_t)t * P ] : 0;
+    double s, xc;
+    int r, c, i;
+
+#pragma omp for schedule(static)
+    for (c=0;c<P;c++) {
+      const TM *Dc = D + (size_t)P * c;
+      TM *MMc = MM + (size_t)P * c;
+      const double ac = AL[c], lc = LAL[c];
+      s = 0;
+      for (r=0;r<P;r++) {
+	MMc[ r ] = (TM)( Dc[ r ] * markovWeight<ALG>( AL[r] , ac , LAL[r] , lc ) ); // D(r,c)
+	s += MMc[ r ];
+      }
+      for (r=0;r<P;r++)
+	MMc[ r ] = (TM)( MMc[ r ] / s );
+      if ( y ) {
+	xc = x[c];
+	for (r=0;r<P;r++)
+	  ylocal[r] += MMc[ r ] * xc;
+      }
+    }
+
+    // the partial products are summed in thread order, so the result
+    // does not depend on scheduling
+    if ( y ) {
+#pragma omp for schedule(static)
+      for (r=0;r<P;r++) {
+	s = 0;
+	for (i=0;i<nt;i++)
+	  s += ypart[ (size_t)i * P + r ];
+	y[r] = s;
+      }
+    }
+  }
+}
+
+template <class TM>
+inline void assignWeightsNormalized(const double *AL, const TM *D, TM *MM, int P, int algtype_i, const double *x = 0, double *y = 0) {
+  std::vector<double> buf;
+  const double *LAL = markovLogs( AL , P , algtype_i , buf );
+  switch ( algtype_i ) {
+  case 1: assignWeightsNormalizedT<1>( AL , LAL , D , MM , P , x , y ); break;
+  case 2: assignWeightsNormalizedT<2>( AL , LAL , D , MM , P , x , y ); break;
+  case 3: assignWeightsNormalizedT<3>( AL , LAL , D , MM , P , x , y ); break;
+  default: assignWeightsNormalizedT<4>( AL , LAL , D , MM , P , x , y ); break;
+  }
+}
+
+// y = MM * x for a P x P column-major matrix. Four columns are streamed at
+// a time against a block of rows, so each pass over the matrix reads and
+// writes y a quarter as often and y stays in L1; the inner loop vectorizes.
+
+template <class TM>
+inline void markovMultiply(const TM *MM, int P, const double *x, double *y) {
+  const int RB = 512;
+  int r0, r1, r, c;
+
+#pragma omp parallel for private(r1,r,c) schedule(static)
+  for (r0=0;r0<P;r0+=RB) {
+    r1 = std::min(P, r0 + RB);
+    for (r=r0;r<r1;r++)
+      y[r] = 0;
+    for (c=0;c+4<=P;c+=4) {
+      const TM *m0 = MM + (size_t)P * c, *m1 = m0 + P, *m2 = m1 + P, *m3 = m2 + P;
+      const double x0 = x[c], x1 = x[c+1], x2 = x[c+2], x3 = x[c+3];
+      for (r=r0;r<r1;r++)
+	y[r] += m0[r] * x0 + m1[r] * x1 + m2[r] * x2 + m3[r] * x3;
+    }
+    for (;c<P;c++) {
+      const TM *m0 = MM + (size_t)P * c;
+      const double x0 = x[c];
+      for (r=r0;r<r1;r++)
+	y[r] += m0[r] * x0;
+    }
+  }
+}
+
+template <class TM>
+struct DenseMarkov {
+  const TM *MM;
+  int P;
+  void operator()(const double *x, double *y) const { markovMultiply(MM, P, x, y); }
+};
+
+// principalEigenvectorRaw.m : power iteration from the uniform vector until
+// the step is below tol, for any markov matrix-times-vector functor
+// (y = markovA * x). first, if given, is markovA times the uniform vector.
+// Returns the number of iterations.
+
+template <class MatVec>
+inline int powerIteration(const MatVec& markovA, int P, double tol, double *v, const double *first = 0) {
+  std::vector<double> oldv(P);
+  double df = 1, s;
+  int i, iter = 0;
+
+  for (i=0;i<P;i++) v[i] = 1.0 / P;
+
+  while ( df > tol ) {
+    std::copy(v, v + P, oldv.begin());
+    if ( iter == 0 && first )
+      std::copy(first, first + P, v);
+    else
+      markovA(&oldv[0], v);
+    df = 0;
+    s = 0;
+    for (i=0;i<P;i++) {
+      df += (oldv[i] - v[i]) * (oldv[i] - v[i]);
+      s += v[i];
+    }
+    df = sqrt(df);
+    iter++;
+    if ( !(s >= 0 && s < std::numeric_limits<double>::infinity()) ) {
+      std::copy(oldv.begin(), oldv.end(), v);
+      break;
+    }
+  }
+
+  s = 0;
+  for (i=0;i<P;i++) s += v[i];
+  for (i=0;i<P;i++) v[i] /= s;
+  return iter;
+}
+
+// One quadratic extrapolation step (Kamvar et al., "Extrapolation methods
+// for accelerating PageRank computations", WWW 2003): from four successive
+// iterates x0..x3, estimates and removes their components along the two
+// subdominant eigenvectors. out is nonnegative and sums to one; returns
+// false (out unchanged) when the fit is degenerate.
+
+inline bool quadraticExtrapolation(const double *x0, const double *x1, const double *x2, const double *x3, int P, double *out) {
+  double a11 = 0, a12 = 0, a22 = 0, b1 = 0, b2 = 0, y1, y2, y3, det, g1, g2, s, o;
+  int i;
+
+  for (i=0;i<P;i++) {
+    y1 = x1[i] - x0[i];
+    y2 = x2[i] - x0[i];
+    y3 = x3[i] - x0[i];
+    a11 += y1 * y1; a12 += y1 * y2; a22 += y2 * y2;
+    b1 += y1 * y3; b2 += y2 * y3;
+  }
+  det = a11 * a22 - a12 * a12;
+  if ( !(det > 1e-12 * a11 * a22) )
+    return false;
+  // least squares [y1 y2] * [g1;g2] = -y3, and g3 = 1
+  g1 = -( a22 * b1 - a12 * b2 ) / det;
+  g2 = -( a11 * b2 - a12 * b1 ) / det;
+
+  s = 0;
+  for (i=0;i<P;i++) {
+    o = (g1 + g2 + 1) * x1[i] + (g2 + 1) * x2[i] + x3[i];
+    s += (o > 0) ? o : 0;
+  }
+  if ( !(s > 0 && s < std::numeric_limits<double>::infinity()) )
+    return false;
+  for (i=0;i<P;i++) {
+    o = (g1 + g2 + 1) * x1[i] + (g2 + 1) * x2[i] + x3[i];
+    out[i] = ((o > 0) ? o : 0) / s;
+  }
+  return true;
+}
+
+// Power iteration with a quadratic extrapolation every
+// GBVS_EXTRAPOLATION_PERIOD products, starting from v0 (e.g. the equilibrium
+// of a previous, similar markov matrix) if given, or the uniform vector. It
+// stops on the rule of principalEigenvectorRaw.m: the last product changed
+// the vector by no more than tol. first, if given, is markovA times the
+// start vector. Returns the number of products.
+
+#define GBVS_EXTRAPOLATION_PERIOD 6
+
+template <class MatVec>
+inline int extrapolatedPowerIteration(const MatVec& markovA, int P, double tol, double *v, const double *v0 = 0, const double *first = 0) {
+  std::vector<double> hist( 4 * (size_t)P );  // last four iterates, as a ring
+  std::vector<double> oldv(P);
+  double df = 1, s;
+  int i, iter = 0, n = 0;
+
+  s = 0;
+  for (i=0;i<P;i++) {
+    v[i] = v0 ? myabs( v0[i] ) : 1.0;
+    s += v[i];
+  }
+  for (i=0;i<P;i++) v[i] /= s;
+  std::copy(v, v + P, hist.begin());
+  n = 1;
+
+  while ( df > tol ) {
+    std::copy(v, v + P, oldv.begin());
+    if ( iter == 0 && first )
+      std::copy(first, first + P, v);
+    else
+      markovA(&oldv[0], v);
+    df = 0;
+    s = 0;
+    for (i=0;i<P;i++) {
+      df += (oldv[i] - v[i]) * (oldv[i] - v[i]);
+      s += v[i];
+    }
+    df = sqrt(df);
+    iter++;
+    if ( !(s >= 0 && s < std::numeric_limits<double>::infinity()) ) {
+      std::copy(oldv.begin(), oldv.end(), v);
+      break;
+    }
+    std::copy(v, v + P, hist.begin() + (size_t)(n % 4) * P);
+    n++;
+    if ( df > tol && n >= 4 && iter % GBVS_EXTRAPOLATION_PERIOD == 0 ) {
+      const double *x0 = &hist[ (size_t)((n - 4) % 4) * P ];
+      const double *x1 = &hist[ (size_t)((n - 3) % 4) * P ];
+      const double *x2 = &hist[ (size_t)((n - 2) % 4) * P ];
+      if ( quadraticExtrapolation( x0 , x1 , x2 , v , P , v ) ) {
+	std::copy(v, v + P, hist.begin());
+	n = 1;
+      }
+    }
+  }
+
+  s = 0;
+  for (i=0;i<P;i++) s += v[i];
+  for (i=0;i<P;i++) v[i] /= s;
+  return iter;
+}
+
+//  [v,iters] = mexMarkovEquilibrium( AL , Dw , MM , algtype , tol , accel , v0 )
+//
+//  one graphsalapply iteration: mexAssignWeights, mexColumnNormalize and
+//  principalEigenvectorRaw with the fused kernels above. MM is P x P
+//  workspace; v may be the same array as AL. With accel, the eigenvector is
+//  found by extrapolatedPowerIteration, from v0 if given.
+
+template <class TM>
+inline int markovEquilibrium(const double *AL, const TM *Dw, TM *MM, int P, int algtype_i, double tol, double *v, bool accel = false, const double *v0 = 0) {
+  std::vector<double> u(P, 1.0 / P), first(P);
+  double s = 0;
+  int i;
+
+  if ( accel && v0 ) {
+    for (i=0;i<P;i++) s += myabs( v0[i] );
+    for (i=0;i<P;i++) u[i] = myabs( v0[i] ) / s;
+  }
+  assignWeightsNormalized( AL , Dw , MM , P , algtype_i , &u[0] , &first[0] );
+  DenseMarkov<TM> M = { MM, P };
+  if ( accel )
+    return extrapolatedPowerIteration( M , P , tol , v , &u[0] , &first[0] );
+  return powerIteration( M , P , tol , v , &first[0] );
+}
+
+// Sparse variant of assignWeightsNormalized, for a P x P matrix stored by
+// columns (as MATLAB sparse matrices are): the entries of column c are at
+// rows Ir[ Jc[c] .. Jc[c+1]-1 ]. The distance multiplier exp(-D/(2 sig^2))
+// of every entry is computed from its distance Sd on the fly.
+
+template <int ALG, class TM>
+inline void assignWeightsNormalizedSparseT(const double *AL, const double *LAL, const int *Jc, const int *Ir, const double *Sd, double sig, TM *MM, int P) {
+  const double k = -1 / (2 * sig * sig);
+  double s;
+  int r, c, e;
+
+#pragma omp parallel for private(r,e,s) schedule(dynamic,64)
+  for (c=0;c<P;c++) {
+    const double ac = AL[c], lc = LAL[c];
+    s = 0;
+    for (e=Jc[c];e<Jc[c+1];e++) {
+      r = Ir[e];
+      MM[ e ] = (TM)( exp( k * Sd[ e ] ) * markovWeight<ALG>( AL[r] , ac , LAL[r] , lc ) );
+      s += MM[ e ];
+    }
+    for (e=Jc[c];e<Jc[c+1];e++)
+      MM[ e ] = (TM)( MM[ e ] / s );
+  }
+}
+
+template <class TM>
+inline void assignWeightsNormalizedSparse(const double *AL, const int *Jc, const int *Ir, const double *Sd, double sig, TM *MM, int P, int algtype_i) {
+  std::vector<double> buf;
+  const double *LAL = markovLogs( AL , P , algtype_i , buf );
+  switch ( algtype_i ) {
+  case 1: assignWeightsNormalizedSparseT<1>( AL , LAL , Jc , Ir , Sd , sig , MM , P ); break;
+  case 2: assignWeightsNormalizedSparseT<2>( AL , LAL , Jc , Ir , Sd , sig , MM , P ); break;
+  case 3: assignWeightsNormalizedSparseT<3>( AL , LAL , Jc , Ir , Sd , sig , MM , P ); break;
+  default: assignWeightsNormalizedSparseT<4>( AL , LAL , Jc , Ir , Sd , sig , MM , P ); break;
+  }
+}
+
+template <class TM>
+struct SparseMarkov {
+  const int *Jc, *Ir;
+  const TM *MM;
+  int P;
+  void operator()(const double *x, double *y) const {
+    int c, e;
+    for (c=0;c<P;c++) y[c] = 0;
+    for (c=0;c<P;c++) {
+      const double xc = x[c];
+      for (e=Jc[c];e<Jc[c+1];e++)
+	y[ Ir[e] ] += MM[ e ] * xc;
+    }
+  }
+};
+
+//  Vo = mexSumOverScales( v , lx , N )
+//
+//  name      dim       description
+// -------------------------------------------------------------------------
+//  v        P x 1      values of vector linearized
+//  lx       P x (2+K)  K = lx(i,2)  # of locations corresponding to i
+//                      lx(i,3:3+K)  individual locations corresponding to i
+//  N        1 x 1      # of locations in original size map
+//  Vo       N x 1      components of v summed and collapsed according to lx
+
+template <class T>
+inline void sumOverScales(const T *v, const double *lx, int P, int N, T *Vo) {
+  double vtmp;
+  int i, j, K, P2, locum;
+
+  for (i=0;i<N;i++)
+    Vo[i] = 0;
+
+  P2 = 2 * P;
+  for (i=0;i<P;i++) {
+    K = (int)lx[ P + i ];
+    vtmp = v[i] / (double)K;
+    for (j=0;j<K;j++) {
+      locum = (int)lx[ P2 + j*P + i ];
+      Vo[ locum ] = (T)( Vo[ locum ] + vtmp );
+    }
+  }
+}
+
+//  lxi = mexLocationIndex( lx , N )
+//
+//  the location map lx of makeLocationMap.m (see sumOverScales), inverted
+//  into compressed rows of int32, all packed in one array:
+//
+//  lxi = [ N ; P ; Lp (N+1) ; Lk (P) ; Li ]
+//
+//  the nodes covering location i are Li[ Lp[i] .. Lp[i+1]-1 ], in increasing
+//  order, and node n covers Lk[n] locations. Each location is covered by one
+//  node per scale, so this is about N * (K + 1) + P integers, where lx has
+//  P * (2 + the most locations of a node) doubles.
+
+inline int locationIndexSize(const double *lx, int P, int N) {
+  int i, nnz = 0;
+  for (i=0;i<P;i++)
+    nnz += (int)lx[ P + i ];
+  return 2 + (N + 1) + P + nnz;
+}
+
+inline void locationIndex(const double *lx, int P, int N, int *lxi) {
+  int *Lp = lxi + 2, *Lk = Lp + N + 1, *Li = Lk + P;
+  int i, j, K, locum;
+
+  lxi[0] = N;
+  lxi[1] = P;
+  for (i=0;i<=N;i++)
+    Lp[i] = 0;
+  for (i=0;i<P;i++) {
+    K = Lk[i] = (int)lx[ P + i ];
+    for (j=0;j<K;j++)
+      Lp[ (int)lx[ 2*P + j*P + i ] + 1 ]++;
+  }
+  for (i=0;i<N;i++)
+    Lp[i+1] += Lp[i];
+  // nodes in increasing order, using Lp[i] as the fill position of location
+  // i, then shifting Lp back
+  for (i=0;i<P;i++)
+    for (j=0;j<Lk[i];j++) {
+      locum = (int)lx[ 2*P + j*P + i ];
+      Li[ Lp[locum]++ ] = i;
+    }
+  for (i=N;i>0;i--)
+    Lp[i] = Lp[i-1];
+  Lp[0] = 0;
+}
+
+//  checks a location index of L integers for the P nodes of a frame before
+//  it is used (e.g. read from a cache file): the sizes agree with L, Lp is
+//  monotone from 0, every node covers a location, and the nodes are in
+//  0..P-1. false if gatherOverScales could read out of bounds with it.
+
+inline bool validLocationIndex(const int *lxi, long long L, int P) {
+  long long i, nnz;
+  if ( L < 2 || lxi[0] < 0 || lxi[1] != P || P < 0 )
+    return false;
+  const int N = lxi[0];
+  if ( L < 2 + (long long)(N + 1) + P )
+    return false;
+  const int *Lp = lxi + 2, *Lk = Lp + N + 1, *Li = Lk + P;
+  if ( Lp[0] != 0 )
+    return false;
+  for (i=0;i<N;i++)
+    if ( Lp[i+1] < Lp[i] )
+      return false;
+  if ( L != 2 + (long long)(N + 1) + P + Lp[N] )
+    return false;
+  for (i=0, nnz=0;i<P;i++) {
+    if ( Lk[i] < 1 )
+      return false;
+    nnz += Lk[i];
+  }
+  if ( nnz != Lp[N] )
+    return false;
+  for (i=0;i<Lp[N];i++)
+    if ( Li[i] < 0 || Li[i] >= P )
+      return false;
+  return true;
+}
+
+//  Vo = mexGatherOverScales( v , lxi )
+//
+//  same as mexSumOverScales with the location index of mexLocationIndex:
+//  each location sums its nodes (in the order the scatter adds them, so the
+//  results are identical), and the locations are independent.
+
+template <class T>
+inline void gatherOverScales(const T *v, const int *lxi, T *Vo) {
+  const int N = lxi[0], P = lxi[1];
+  const int *Lp = lxi + 2, *Lk = Lp + N + 1, *Li = Lk + P;
+  std::vector<double> vk(P);
+  double s;
+  int i, e;
+
+  for (i=0;i<P;i++)
+    vk[i] = v[i] / (double)Lk[i];
+
+#pragma omp parallel for private(e,s) schedule(static)
+  for (i=0;i<N;i++) {
+    s = 0;
+    for (e=Lp[i];e<Lp[i+1];e++)
+      s += vk[ Li[e] ];
+    Vo[i] = (T)s;
+  }
+}
+
+#endif
@@ -1,6 +1,6 @@
 
 
-function [Anorm,iters] = graphsalapply( A , frame , sigma_frac, num_iters , algtype , tol )
+function [Anorm,iters] = graphsalapply( A , frame , sigma_frac, num_iters , algtype , tol , eig_accel , precision )
 
 %
 %  this function is the heart of GBVS.
@@ -17,6 +17,21 @@ function [Anorm,iters] = graphsalapply( A , frame , sigma_frac, num_iters , algt
 %  tol controls a stopping rule on the computation of the equilibrium distribution (principal eigenvector)
 %  the lower it is, the longer the algorithm runs.
 
+%  eig_accel (optional, default 0): 1 => compute the equilibrium by extrapolated power iteration
+%  (needs mexMarkovEquilibrium), warm-started from the previous equilibrium when num_iters > 1.
+%  it converges to the same distribution in fewer iterations.
+
+%  precision (optional, default 'double'): 'single' => the P x P weight and markov matrices are single,
+%  which halves their memory. the mex functions still compute the weights in double. it needs the
+%  compiled mex files (mexMarkovEquilibrium); with the pre-compiled, double-only ones it falls back to double.
+
+if ( nargin < 7 )
+  eig_accel = 0;
+end
+if ( nargin < 8 )
+  precision = 'double';
+end
+
 if ( algtype == 4 )
   Anorm = A .^ 1.5;
   iters = 1;
@@ -24,38 +39,68 @@ if ( algtype == 4 )
 end
   
 % form a multiresolution pyramid of feature maps according to multilevels
-lx = frame.lx; 
 [ Apyr , dims ] = formMapPyramid( A , frame.multilevels );
 
+% fused weights / normalization / power iteration kernel, if compiled
+fused = ( exist('mexMarkovEquilibrium') == 3 );
+if ( ~fused )
+  precision = 'double';
+end
+
 % get a weight matrix between nodes based on distance matrix
 sig = sigma_frac * mean(size(A));
-Dw = exp( -1 * frame.D / (2 * sig^2) );
+if ( strcmp(precision,'single') )
+  % built as single a block of columns at a time, i.e. without a P x P double
+  P = size(frame.D,2);
+  Dw = zeros( size(frame.D) , 'single' );
+  for j = 1 : 256 : P
+    cols = j : min(j+255,P);
+    Dw(:,cols) = single( exp( -1 * frame.D(:,cols) / (2 * sig^2) ) );
+  end
+else
+  Dw = exp( -1 * frame.D / (2 * sig^2) );
+end
 
 % assign a linear index to each node
 AL = mexArrangeLinear( Apyr , dims );
 
 % create the state transition matrix between nodes
-P = size(lx,1);
-MM = zeros( P , P );
+P = length(AL);
+MM = zeros( P , P , class(Dw) );
 
 iters = 0;
 
 for i=1:num_iters
 
+  if ( fused )
+    if ( eig_accel && i > 1 )
+      [AL,iteri] = mexMarkovEquilibrium( AL , Dw , MM , algtype , tol , eig_accel , AL );
+    else
+      [AL,iteri] = mexMarkovEquilibrium( AL , Dw , MM , algtype , tol , eig_accel );
+    end
+    iters = iters + iteri;
+    continue;
+  end
+
   % assign edge weights based on distances between nodes and algtype  
   mexAssignWeights( AL , Dw , MM , algtype );
 
   % make it a markov matrix (so each column sums to 1)
   mexColumnNormalize( MM );
 
-  % find the principal eigenvector
+  % find the principal eigenvector (double in either precision)
   [AL,iteri] = principalEigenvectorRaw( MM , tol );
+  AL = double( AL );
   iters = iters + iteri;
 
 end
 
 % collapse multiresolution representation back onto one scale
-Vo = mexSumOverScales( AL , lx , prod(size(A)) );
+if ( isfield(frame,'lxi') && exist('mexGatherOverScales') == 3 )
+  Vo = mexGatherOverScales( AL , frame.lxi );
+else
+  Vo = mexSumOverScales( AL , frame.lx , prod(size(A)) );
+end
 
 % arrange the nodes back into a rectangular map
 Anorm = reshape(Vo,size(A));
@@ -0,0 +1,37 @@
+
+function [Anorms,iters] = graphsalapplyBatch( As , frame , sigma_frac, num_iters , algtype , tol , eig_accel , precision )
+
+%
+%  graphsalapply on every map of the cell array As (all of the size of the frame) in one call:
+%  Anorms{i} is the Anorm of As{i}, and iters the total # of power iterations.
+%
+%  with the compiled mexGraphsalapplyBatch, the weight matrix Dw is computed once for all the maps,
+%  and the maps are processed in parallel (OpenMP) by the native library (native/src/gbvs.h).
+%  otherwise graphsalapply is called on each map in turn.
+%
+
+if ( nargin < 7 )
+  eig_accel = 0;
+end
+if ( nargin < 8 )
+  precision = 'double';
+end
+
+Anorms = cell(size(As));
+iters = 0;
+if ( isempty(As) )
+  return;
+end
+
+if ( exist('mexGraphsalapplyBatch') == 3 && isfield(frame,'lxi') )
+  [stack,iters] = mexGraphsalapplyBatch( cat(3,As{:}) , frame , sigma_frac , num_iters , algtype , tol , ...
+                                         eig_accel , strcmp(precision,'single') );
+  for i=1:numel(As)
+    Anorms{i} = stack(:,:,i);
+  end
+else
+  for i=1:numel(As)
+    [Anorms{i},tmp] = graphsalapply( As{i} , frame , sigma_frac , num_iters , algtype , tol , eig_accel , precision );
+    iters = iters + tmp;
+  end
+end
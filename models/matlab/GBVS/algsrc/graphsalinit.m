@@ -29,6 +29,12 @@ dx = distanceMatrix( dims , lx , cyclic_type );
 D = cx .* dx;
 
 frame.D = D;
-frame.lx = lx;
+% compact location index for mexGatherOverScales, if compiled; it replaces
+% the (much larger) location map lx
+if ( exist('mexLocationIndex') == 3 && exist('mexGatherOverScales') == 3 )
+  frame.lxi = mexLocationIndex( lx , prod(map_size) );
+else
+  frame.lx = lx;
+end
 frame.dims = dims;
 frame.multilevels = multilevels;
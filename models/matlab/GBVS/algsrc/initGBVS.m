@@ -16,6 +16,18 @@ if ( param.useIttiKochInsteadOfGBVS )
     param.normalizationType = 3;
     param.normalizeTopChannelMaps = 1;
 end
+if ( ~isfield(param,'eigAccel') )
+    param.eigAccel = 0;
+end
+if ( ~isfield(param,'precision') )
+    param.precision = 'double';
+end
+% the pre-compiled mexAssignWeights/mexColumnNormalize binaries are double
+% only; the typed ones are compiled together with mexMarkovEquilibrium
+if ( ~strcmp(param.precision,'double') && exist('mexMarkovEquilibrium') ~= 3 )
+    mymessage(param,'precision ''%s'' needs the compiled mex files (gbvs_compile): using double\n',param.precision);
+    param.precision = 'double';
+end
 
 param.maxcomputelevel = max(param.levels);
 if (param.activationType==2)
@@ -31,12 +43,33 @@ if ( ~param.useIttiKochInsteadOfGBVS )
   ufile = sprintf('%s__m%s__%s.mat',num2str(salmapsize),num2str(param.multilevels),num2str(param.cyclic_type));
   ufile(ufile==' ') = '_';
   ufile = fullfile( pathroot , 'initcache' ,  ufile );
-  if ( exist(ufile) )
-    grframe = load(ufile);
-    grframe = grframe.grframe;
-  else
-    grframe = graphsalinit( salmapsize , param.multilevels , 2, 2, param.cyclic_type );
-    save(ufile,'grframe');
+  % binary frame cache, shared with other runs and with native/ (see loadFrameCache.m)
+  [upath,uname] = fileparts( ufile );
+  bfile = fullfile( upath , [ uname '.gbvsframe' ] );
+  grframe = [];
+  if ( exist(bfile) )
+    try
+      grframe = loadFrameCache(bfile);
+    catch
+      mymessage(param,'rebuilding frame cache %s\n',bfile);
+    end
+  end
+  if ( isempty(grframe) )
+    if ( exist(ufile) )
+      grframe = load(ufile);
+      grframe = grframe.grframe;
+      % a frame cached with lxi (and without lx) by a build with mexGatherOverScales
+      if ( ~isfield(grframe,'lx') && exist('mexGatherOverScales') ~= 3 )
+        [N,nam] = namenodes( grframe.dims );
+        grframe.lx = makeLocationMap( grframe.dims , nam , N );
+      end
+    else
+      grframe = graphsalinit( salmapsize , param.multilevels , 2, 2, param.cyclic_type );
+    end
+    % without mexLocationIndex there is no binary cache: keep a .mat one
+    if ( ~saveFrameCache(bfile,grframe) && ~exist(ufile) )
+      save(ufile,'grframe');
+    end
   end
 else
   grframe = [];
@@ -0,0 +1,75 @@
+%
+% reads a frame written by saveFrameCache.m (or by the native library, see
+% native/src/gbvsCache.h). the arrays are read through memmapfile, but each
+% process gets its own copy of them; only the pages of the OS file cache are
+% shared with other processes reading the same frame.
+%
+% the header is checked against the file before anything is mapped: every
+% array must lie within the file, and the size of lxi must match its own
+% header (N, P and the node offsets Lp).
+%
+% the file does not hold the location map lx of graphsalinit.m; it is rebuilt
+% from dims when mexGatherOverScales (which uses lxi instead) is not compiled.
+%
+
+function frame = loadFrameCache( fname )
+
+fid = fopen( fname , 'r' );
+if ( fid < 0 )
+  error('loadFrameCache: cannot read %s', fname);
+end
+magic = fread( fid , [1 8] , 'char*1=>char' );
+hdr = fread( fid , [1 8] , 'int32' );
+offset = fread( fid , [1 7] , 'int64' );
+count = fread( fid , [1 7] , 'int64' );
+fileSize = fread( fid , 1 , 'int64' );
+headerSize = ftell( fid );
+info = dir( fname );
+
+if ( numel(magic) ~= 8 || numel(hdr) ~= 8 || numel(offset) ~= 7 || numel(count) ~= 7 || ...
+     numel(fileSize) ~= 1 || ~strcmp(magic(1:7),'GBVSFRM') || ...
+     hdr(1) ~= 2 || hdr(2) ~= hex2dec('01020304') )
+  fclose( fid );
+  error('loadFrameCache: %s is not a frame cache file', fname);
+end
+P = hdr(5); N = hdr(6); K = hdr(8);
+if ( count(3) ~= P * P )
+  fclose( fid );
+  error('loadFrameCache: %s holds a sparse frame, graphsalapply.m needs a dense one', fname);
+end
+
+% arrays in file order: multilevels dims D Sp Si Sd lxi
+elemSize = [ 4 8 8 4 4 8 4 ];
+bad = P < 1 || K < 1 || N < 1 || N ~= hdr(3) * hdr(4) || hdr(7) ~= K - 1 || ...
+      fileSize > info.bytes || count(1) ~= K - 1 || count(2) ~= 2 * K || ...
+      count(3) ~= P * P || count(7) < 2 + (N + 1) + P || ...
+      any( count < 0 | offset < headerSize | offset + count .* elemSize > fileSize );
+if ( ~bad )
+  % the lxi header: [N; P; Lp(N+1)], with numel(lxi) = 2+(N+1)+P+Lp(N+1)
+  fseek( fid , offset(7) , 'bof' );
+  lxihdr = fread( fid , [ 1 2+N+1 ] , 'int32' );
+  bad = numel(lxihdr) ~= 2 + N + 1 || lxihdr(1) ~= N || lxihdr(2) ~= P || ...
+        count(7) ~= 2 + (N + 1) + P + lxihdr(end);
+end
+fclose( fid );
+if ( bad )
+  error('loadFrameCache: %s is truncated or corrupt', fname);
+end
+
+frame.D = mapArray( fname , offset(3) , 'double' , [ P P ] );
+frame.lxi = mapArray( fname , offset(7) , 'int32' , [ count(7) 1 ] );
+frame.dims = mapArray( fname , offset(2) , 'double' , [ K 2 ] );
+frame.multilevels = double( mapArray( fname , offset(1) , 'int32' , [ 1 K-1 ] ) );
+if ( exist('mexGatherOverScales') ~= 3 )
+  [N,nam] = namenodes( frame.dims );
+  frame.lx = makeLocationMap( frame.dims , nam , N );
+end
+
+function A = mapArray( fname , offset , type , sz )
+
+if ( prod(sz) == 0 )
+  A = zeros(sz);
+  return;
+end
+m = memmapfile( fname , 'Offset' , offset , 'Format' , { type , sz , 'A' } , 'Repeat' , 1 );
+A = m.Data.A;
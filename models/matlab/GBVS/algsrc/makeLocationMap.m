@@ -1,13 +1,16 @@
 function lx = makeLocationMap( dims , nam , N )
 
 Nmaps = size(dims,1);
-lx = zeros(N , 2^13 + 3 );
 
+% a node covers at most (largest row bin) x (largest column bin) locations
 px = {};
+maxL = 0;
 for i = 1 : Nmaps
     px{i}.r = partitionindex( dims(1,1) , dims(i,1) );
     px{i}.c = partitionindex( dims(1,2) , dims(i,2) );
+    maxL = max( maxL , max(accumarray(px{i}.r(2,:)',1)) * max(accumarray(px{i}.c(2,:)',1)) );
 end
+lx = zeros(N , maxL + 2 );
 
 for i = 1 : Nmaps
     for j = 1 : dims(i,1)
@@ -34,5 +37,3 @@ for i = 1 : Nmaps
     end
 end
 
-maxL = max( lx(:,2) );
-lx = lx( : , 1 : maxL + 2 );
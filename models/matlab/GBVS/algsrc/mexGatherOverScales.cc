@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mex.h>
+#include <math.h>
+#include <matrix.h>
+#include <string.h>
+
+#include "gbvsKernels.h"
+
+//  Vo = mexGatherOverScales( v , lxi )
+//
+//  name      dim       description
+// -------------------------------------------------------------------------
+//  v        P x 1      values of vector linearized
+//  lxi      L x 1      int32 location index of mexLocationIndex
+//  Vo       N x 1      components of v summed and collapsed, as in
+//                      mexSumOverScales (single if v is single)
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+  // Declarations
+  const int *lxi;
+
+  if ( nrhs < 2 || !mxIsInt32(prhs[1]) ||
+       !validLocationIndex( (const int*)mxGetData(prhs[1]) ,
+                            (long long)mxGetNumberOfElements(prhs[1]) ,
+                            (int)mxGetM(prhs[0]) ) )
+    mexErrMsgTxt("mexGatherOverScales: lxi must be the int32 location index of the nodes of v");
+
+  lxi = (const int*)mxGetData(prhs[1]);
+
+  if ( mxIsSingle(prhs[0]) ) {
+    plhs[0] = mxCreateNumericMatrix(lxi[0], 1, mxSINGLE_CLASS, mxREAL);
+    gatherOverScales( (const float*)mxGetData(prhs[0]) , lxi , (float*)mxGetData(plhs[0]) );
+  } else {
+    plhs[0] = mxCreateDoubleMatrix(lxi[0], 1, mxREAL);
+    gatherOverScales( mxGetPr(prhs[0]) , lxi , mxGetPr(plhs[0]) );
+  }
+
+  return;
+}
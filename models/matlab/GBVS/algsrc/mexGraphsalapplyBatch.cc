@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mex.h>
+#include <math.h>
+#include <matrix.h>
+#include <string.h>
+#include <vector>
+
+#include "gbvs.h"
+#include "gbvsKernels.h"
+
+//  [Anorms,iters] = mexGraphsalapplyBatch( As , frame , sigma_frac , num_iters , algtype , tol , accel , single )
+//
+//  name        dim      description
+// -------------------------------------------------------------------------
+//  As          hxwxM    M maps of the size of the frame
+//  frame       struct   frame of graphsalinit.m (D, dims, multilevels, lxi)
+//  sigma_frac  1x1      as in graphsalapply.m
+//  num_iters   1x1      as in graphsalapply.m
+//  algtype     1x1      as in graphsalapply.m
+//  tol         1x1      as in graphsalapply.m
+//  accel       1x1      as eig_accel in graphsalapply.m
+//  single      1x1      1 => single precision markov matrices
+//  Anorms      hxwxM    Anorms(:,:,i) = graphsalapply( As(:,:,i) , ... )
+//  iters       1x1      total # of power iterations
+//
+//  graphsalapplyBatch of the native library (native/src/gbvs.h): Dw is
+//  computed once for all the maps, and the maps run in parallel.
+
+static const mxArray *frameField(const mxArray *frame, const char *name) {
+  const mxArray *f = mxGetField(frame, 0, name);
+  if ( !f )
+    mexErrMsgIdAndTxt("GBVS:mexGraphsalapplyBatch", "frame has no field %s", name);
+  return f;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+  // Declarations
+  const mwSize *dims;
+  const mxArray *D, *fdims, *fmultilevels, *flxi;
+  int h, w, M, i, num_iters, algtype_i, iters;
+  double sigma_frac, tol;
+  bool accel, single;
+
+  if ( nrhs < 6 || !mxIsStruct(prhs[1]) )
+    mexErrMsgTxt("usage: [Anorms,iters] = mexGraphsalapplyBatch( As , frame , sigma_frac , num_iters , algtype , tol , accel , single )");
+
+  dims = mxGetDimensions(prhs[0]);
+  h = dims[0];
+  w = dims[1];
+  M = mxGetNumberOfDimensions(prhs[0]) > 2 ? dims[2] : 1;
+  sigma_frac = mxGetScalar(prhs[2]);
+  num_iters = (int)mxGetScalar(prhs[3]);
+  algtype_i = (int)mxGetScalar(prhs[4]);
+  tol = mxGetScalar(prhs[5]);
+  accel = nrhs > 6 && mxGetScalar(prhs[6]) != 0;
+  single = nrhs > 7 && mxGetScalar(prhs[7]) != 0;
+
+  D = frameField(prhs[1], "D");
+  fdims = frameField(prhs[1], "dims");
+  fmultilevels = frameField(prhs[1], "multilevels");
+  flxi = frameField(prhs[1], "lxi");
+  if ( !mxIsDouble(prhs[0]) || !mxIsDouble(D) || !mxIsDouble(fdims) )
+    mexErrMsgTxt("mexGraphsalapplyBatch: As, frame.D and frame.dims must be double");
+  if ( !mxIsInt32(flxi) ||
+       !validLocationIndex( (const int*)mxGetData(flxi) ,
+                            (long long)mxGetNumberOfElements(flxi) , (int)mxGetM(D) ) ||
+       ((const int*)mxGetData(flxi))[0] != h * w )
+    mexErrMsgTxt("mexGraphsalapplyBatch: frame.lxi must be the int32 location index of the frame, and As of its size");
+
+  // the frame as the native library sees it
+  std::vector<int> multilevels(mxGetNumberOfElements(fmultilevels));
+  for (i=0;i<(int)multilevels.size();i++)
+    multilevels[i] = (int)mxGetPr(fmultilevels)[i];
+  GBVSFrameView frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.rows = h;
+  frame.cols = w;
+  frame.numMultilevels = (int)multilevels.size();
+  frame.multilevels = multilevels.empty() ? 0 : &multilevels[0];
+  frame.dims = mxGetPr(fdims);
+  frame.P = mxGetM(D);
+  frame.D = mxGetPr(D);
+  frame.lxi = (const int*)mxGetData(flxi);
+
+  plhs[0] = mxCreateNumericArray(mxGetNumberOfDimensions(prhs[0]), dims, mxDOUBLE_CLASS, mxREAL);
+
+  iters = graphsalapplyBatch( mxGetPr(prhs[0]) , M , frame , sigma_frac , num_iters ,
+                              algtype_i , tol , mxGetPr(plhs[0]) , accel ,
+                              single ? GBVS_SINGLE : GBVS_DOUBLE );
+
+  if ( nlhs > 1 )
+    plhs[1] = mxCreateDoubleScalar( (double)iters );
+
+  return;
+}
@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mex.h>
+#include <math.h>
+#include <matrix.h>
+#include <string.h>
+
+#include "gbvsKernels.h"
+
+//  lxi = mexLocationIndex( lx , N )
+//
+//  name      dim       description
+// -------------------------------------------------------------------------
+//  lx       P x (2+K)  location map (see mexSumOverScales)
+//  N        1 x 1      # of locations in original size map
+//  lxi      L x 1      int32 location index (see gbvsKernels.h), for
+//                      mexGatherOverScales
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+  // Declarations
+  double *lx;
+  int N, P, L;
+
+  lx = mxGetPr(prhs[0]);
+  P = mxGetM(prhs[0]);
+  N = (int)mxGetScalar(prhs[1]);
+
+  L = locationIndexSize( lx , P , N );
+  plhs[0] = mxCreateNumericMatrix(L, 1, mxINT32_CLASS, mxREAL);
+
+  locationIndex( lx , P , N , (int*)mxGetData(plhs[0]) );
+
+  return;
+}
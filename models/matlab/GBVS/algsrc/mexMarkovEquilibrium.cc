@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mex.h>
+#include <math.h>
+#include <matrix.h>
+#include <string.h>
+#include <vector>
+
+#include "gbvsKernels.h"
+
+//  [v,iters] = mexMarkovEquilibrium( AL , Dw , MM , algtype , tol , accel , v0 )
+//
+//  name      dim    description
+// -------------------------------------------
+//  AL        Px1    values of map linearized
+//  Dw        PxP    w=Dw(i,j)==Dw(j,i) is dist multiplier for i & j
+//  MM        PxP    workspace for the markov matrix
+//  algtype   1x1    algorith type (see gbvsKernels.h)
+//  tol       1x1    stopping rule of the power iteration
+//  accel     1x1    (optional) 1 => extrapolated power iteration
+//  v0        Px1    (optional) start vector of the accelerated iteration
+//  v         Px1    equilibrium distribution of the markov chain
+//  iters     1x1    # of power iterations
+//
+//  Same result as mexAssignWeights, mexColumnNormalize and
+//  principalEigenvectorRaw in sequence, with fewer passes over MM. With
+//  accel, the same equilibrium to within tol in fewer iterations.
+//
+//  Dw and MM may both be single instead of double, to halve the memory of
+//  the markov matrix (see gbvsKernels.h); v is double either way.
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+  //Declarations
+  double *AL, *v, *v0 = 0;
+  std::vector<double> ALd;
+  int P, algtype_i, iters;
+  bool accel = false;
+  double tol;
+
+  P = mxGetM(prhs[0]);
+  if ( mxIsSingle(prhs[0]) ) {
+    const float *ALs = (const float*)mxGetData(prhs[0]);
+    ALd.assign( ALs , ALs + P );
+    AL = &ALd[0];
+  } else
+    AL = mxGetPr(prhs[0]);
+  if ( mxIsSingle(prhs[1]) != mxIsSingle(prhs[2]) )
+    mexErrMsgTxt("mexMarkovEquilibrium: Dw and MM must both be double or both be single");
+  algtype_i = (int)mxGetScalar(prhs[3]);
+  tol = mxGetScalar(prhs[4]);
+  if ( nrhs > 5 )
+    accel = ( mxGetScalar(prhs[5]) != 0 );
+  if ( nrhs > 6 && mxGetNumberOfElements(prhs[6]) == (size_t)P && mxIsDouble(prhs[6]) )
+    v0 = mxGetPr(prhs[6]);
+
+  plhs[0] = mxCreateDoubleMatrix(P, 1, mxREAL);
+  v = mxGetPr(plhs[0]);
+
+  if ( mxIsSingle(prhs[2]) )
+    iters = markovEquilibrium( AL , (const float*)mxGetData(prhs[1]) , (float*)mxGetData(prhs[2]) ,
+                               P , algtype_i , tol , v , accel , v0 );
+  else
+    iters = markovEquilibrium( AL , mxGetPr(prhs[1]) , mxGetPr(prhs[2]) ,
+                               P , algtype_i , tol , v , accel , v0 );
+
+  if ( nlhs > 1 )
+    plhs[1] = mxCreateDoubleScalar( (double)iters );
+
+  return;
+}
@@ -6,6 +6,8 @@
 #include <matrix.h>
 #include <string.h>
 
+#include "gbvsKernels.h"
+
 //  Vo = mexSumOverScales( v , lx , N )
 //
 //  name      dim       description
@@ -15,17 +17,17 @@
 //                      lx(i,3:3+K)  individual locations corresponding to i
 //  N        1 x 1      # of locations in original size map
 //  Vo       N x 1      components of v summed and collapsed according to lx
+//                      (single if v is single)
 
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
 
   // Declarations
   mxArray *var, *lxar, *Nar;
-  double *v, *lx, *Nd, *Vo, vtmp;
-  int i, j, K , N, P , P2, locum;
+  double *lx, *Nd;
+  int N, P;
 
   // get v
   var = (mxArray*)prhs[0];
-  v = mxGetPr(var);
   P = mxGetM(var);
 
   // get lx
@@ -38,23 +40,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
   N = (int)Nd[0];
 
   // allocate Vo
-  plhs[0] = mxCreateDoubleMatrix(N, 1, mxREAL);
-  Vo = mxGetPr(plhs[0]);
-
-  for (i=0;i<N;i++)
-    Vo[i] = 0;
-
-  P2 = 2 * P;
-  for (i=0;i<P;i++) {
-    K = (int)lx[ P + i ];
-    vtmp = v[i] / (double)K;
-    for (j=0;j<K;j++) {
-      locum = (int)lx[ P2 + j*P + i ];
-      Vo[ locum ] += vtmp;
-    }
+  if ( mxIsSingle(var) ) {
+    plhs[0] = mxCreateNumericMatrix(N, 1, mxSINGLE_CLASS, mxREAL);
+    sumOverScales( (const float*)mxGetData(var) , lx , P , N , (float*)mxGetData(plhs[0]) );
+  } else {
+    plhs[0] = mxCreateDoubleMatrix(N, 1, mxREAL);
+    sumOverScales( mxGetPr(var) , lx , P , N , mxGetPr(plhs[0]) );
   }
 
   return;
 }
 
-
@@ -7,7 +7,7 @@
 function [v,iter] = principalEigenvectorRaw( markovA , tol )
 
 if ( sparseness(markovA) < .4 )
-     markovA = sparse(markovA);
+     markovA = sparse(double(markovA));
 end
 
 D = size(markovA,1);
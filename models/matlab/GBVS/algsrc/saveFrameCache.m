@@ -0,0 +1,63 @@
+%
+% writes a frame of graphsalinit.m to a binary frame cache file, which
+% loadFrameCache.m and the native library (native/src/gbvsCache.h) map
+% read-only. the file is written under a temporary name and then moved into
+% place, so that concurrent runs never read a partial file.
+%
+% the file holds the location index lxi of mexLocationIndex. without it (and
+% without a compiled mexLocationIndex) nothing is written and saved is false.
+%
+
+function saved = saveFrameCache( fname , frame )
+
+saved = false;
+P = size(frame.D,1);
+K = size(frame.dims,1);
+N = prod(frame.dims(1,:));
+if ( ~isfield(frame,'lxi') )
+  if ( exist('mexLocationIndex') ~= 3 )
+    return;
+  end
+  frame.lxi = mexLocationIndex( frame.lx , N );
+end
+align = 64;
+headerSize = 160;
+
+% arrays in file order: multilevels dims D Sp Si Sd lxi (a dense frame has
+% no Sp/Si/Sd)
+data = { int32(frame.multilevels(:)) , frame.dims , frame.D , ...
+         int32([]) , int32([]) , [] , frame.lxi };
+elemSize = [ 4 8 8 4 4 8 4 ];
+count = cellfun( @numel , data );
+offset = zeros(1,7);
+pos = ceil( headerSize / align ) * align;
+for i = 1 : 7
+  offset(i) = pos;
+  pos = ceil( (pos + count(i) * elemSize(i)) / align ) * align;
+end
+
+% the temporary name is unique to this call (the name part of tempname),
+% also between the hosts that share a cache directory
+[ ~ , uniq ] = fileparts( tempname );
+tmpname = sprintf('%s.tmp%d_%s', fname, feature('getpid'), uniq);
+fid = fopen( tmpname , 'w' );
+if ( fid < 0 )
+  error('saveFrameCache: cannot write %s', tmpname);
+end
+fwrite( fid , [ 'GBVSFRM' 0 ] , 'char*1' );
+fwrite( fid , [ 2 hex2dec('01020304') frame.dims(1,1) frame.dims(1,2) P N K-1 K ] , 'int32' );
+fwrite( fid , offset , 'int64' );
+fwrite( fid , count , 'int64' );
+fwrite( fid , pos , 'int64' );
+for i = 1 : 7
+  fwrite( fid , zeros(1, offset(i) - ftell(fid)) , 'uint8' );
+  if ( isinteger(data{i}) )
+    fwrite( fid , data{i} , 'int32' );
+  else
+    fwrite( fid , data{i} , 'double' );
+  end
+end
+fwrite( fid , zeros(1, pos - ftell(fid)) , 'uint8' );
+fclose( fid );
+movefile( tmpname , fname , 'f' );
+saved = true;
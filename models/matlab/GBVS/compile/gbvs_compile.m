@@ -1,19 +1,33 @@
 
 % cleanmex
 
+% OpenMP for the parallel kernels (without it they run single-threaded)
+if ispc
+  ompflags = {'COMPFLAGS=$COMPFLAGS /openmp'};
+else
+  ompflags = {'CXXFLAGS=$CXXFLAGS -fopenmp','LDFLAGS=$LDFLAGS -fopenmp'};
+end
+
 cd util
-mex('myContrast.cc');
+mex(ompflags{:},'myContrast.cc');
 cd ../
 
 cd algsrc
 mex('mexArrangeLinear.cc');
-mex('mexAssignWeights.cc');
-mex('mexColumnNormalize.cc');
+mex(ompflags{:},'mexAssignWeights.cc');
+mex(ompflags{:},'mexColumnNormalize.cc');
 mex('mexSumOverScales.cc');
+mex('mexLocationIndex.cc');
+mex(ompflags{:},'mexGatherOverScales.cc');
 mex('mexVectorToMap.cc');
+mex(ompflags{:},'mexMarkovEquilibrium.cc');
+% built on the native library (../native/src)
+mex(ompflags{:},'-I.','-I../native/src','-I../saltoolbox','mexGraphsalapplyBatch.cc', ...
+    '../native/src/gbvs.cc','../native/src/mapPyramid.cc');
 cd ../
 
 cd saltoolbox/
 mex('mySubsample.cc');
-mex('mexLocalMaximaGBVS.cc');
+mex(ompflags{:},'mexImagePyramid.cc');
+mex(ompflags{:},'mexLocalMaximaGBVS.cc');
 cd ../
@@ -10,10 +10,15 @@ mex -maci64 mexArrangeLinear.cc ;
 mex -maci64 mexAssignWeights.cc ;
 mex -maci64 mexColumnNormalize.cc ;
 mex -maci64 mexSumOverScales.cc ;
+mex -maci64 mexLocationIndex.cc ;
+mex -maci64 mexGatherOverScales.cc ;
 mex -maci64 mexVectorToMap.cc ;
+mex -maci64 mexMarkovEquilibrium.cc ;
+mex -maci64 -I. -I../native/src -I../saltoolbox mexGraphsalapplyBatch.cc ../native/src/gbvs.cc ../native/src/mapPyramid.cc ;
 cd ../
 
 cd saltoolbox/
 mex -maci64 mySubsample.cc ;
+mex -maci64 mexImagePyramid.cc ;
 mex -maci64 mexLocalMaximaGBVS.cc ;
 cd ../
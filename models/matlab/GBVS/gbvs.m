@@ -20,6 +20,9 @@ function [out,motionInfo] = gbvs(img,param,prevMotionInfo)
 %    - intermed_maps contains all the intermediate maps computed along the way (act. & norm.)         %
 %      which are used to compute feat_maps, which is then combined into master_map                    %
 %    - rawfeatmaps contains all the feature maps computed at the various scales                       %
+%    - eigIters is the total # of power iterations spent on equilibrium distributions                 %
+%    - precisionDeviation (param.precision = 'validate' only) is the largest difference of the        %
+%      single and double precision master maps                                                        %
 %                                                                                                     %
 %  Jonathan Harel, Last Revised Aug 2008. jonharel@gmail.com                                          %
 %
@@ -45,6 +48,17 @@ if ( (nargin < 4) || (~exist('prevMotionInfo')) )
     prevMotionInfo = [];
 end
 
+if ( strcmp(param.precision,'validate') )
+    % compute the map in both precisions; out is the double one
+    param.precision = 'single';
+    outs = gbvs( img , param , prevMotionInfo );
+    param.precision = 'double';
+    [out,motionInfo] = gbvs( img , param , prevMotionInfo );
+    out.precisionDeviation = max( abs( out.master_map(:) - outs.master_map(:) ) );
+    mymessage(param,'largest difference of the single and double precision master maps: %g\n', out.precisionDeviation);
+    return;
+end
+
 if ( param.useIttiKochInsteadOfGBVS )
     mymessage(param,'NOTE: Computing STANDARD Itti/Koch instead of Graph-Based Visual Saliency (GBVS)\n\n');
 end
@@ -67,6 +81,7 @@ map_types = {};
 allmaps = {};
 i = 0;
 mymessage(param,'computing activation maps...\n');
+eigIters = 0;
 for fmapi=1:length(mapnames)
     mapsobj = eval( [ 'rawfeatmaps.' mapnames{fmapi} ';'] );
     numtypes = mapsobj.info.numtypes;
@@ -77,8 +92,8 @@ for fmapi=1:length(mapnames)
             for lev = param.levels
                 mymessage(param,'making a graph-based activation (%s) feature map.\n',mapnames{fmapi});
                 i = i + 1;
-                [allmaps{i}.map,tmp] = graphsalapply( mapsobj.maps.val{typei}{lev} , ...
-                    grframe, param.sigma_frac_act , 1 , 2 , param.tol );
+                % activated below, all maps in one call
+                allmaps{i}.map = mapsobj.maps.val{typei}{lev};
                 allmaps{i}.maptype = [ fmapi typei lev ];
             end
         else
@@ -96,6 +111,13 @@ for fmapi=1:length(mapnames)
         end
     end
 end
+if ( param.activationType == 1 && ~isempty(allmaps) )
+    maps = cell(1,length(allmaps));
+    for i=1:length(allmaps), maps{i} = allmaps{i}.map; end
+    [maps,tmp] = graphsalapplyBatch( maps , grframe, param.sigma_frac_act , 1 , 2 , param.tol , param.eigAccel , param.precision );
+    eigIters = eigIters + tmp;
+    for i=1:length(allmaps), allmaps{i}.map = maps{i}; end
+end
 
 
 %%%%
@@ -104,19 +126,32 @@ end
 
 mymessage(param,'normalizing activation maps...\n');
 norm_maps = {};
+if ( param.normalizationType ~= 1 && param.normalizationType ~= 2 && ~isempty(allmaps) )
+    % the local maxima of every map are found in one mex call
+    stack = zeros([param.salmapsize length(allmaps)]);
+    for i=1:length(allmaps)
+        stack(:,:,i) = mat2gray(imresize(allmaps{i}.map,param.salmapsize, 'bicubic'));
+    end
+    stack = maxNormalizeStdGBVS( stack );
+elseif ( ~isempty(allmaps) )
+    % every map in one call
+    if ( param.normalizationType == 1 ), algtype = 4; else, algtype = 1; end
+    maps = cell(1,length(allmaps));
+    for i=1:length(allmaps), maps{i} = allmaps{i}.map; end
+    [maps,tmp] = graphsalapplyBatch( maps , grframe, param.sigma_frac_norm, param.num_norm_iters, algtype , param.tol , param.eigAccel , param.precision );
+    eigIters = eigIters + tmp;
+end
 for i=1:length(allmaps)
     mymessage(param,'normalizing a feature map (%d)... ', i);
     if ( param.normalizationType == 1 )
         mymessage(param,' using fast raise to power scheme\n ', i);
-        algtype = 4;
-        [norm_maps{i}.map,tmp] = graphsalapply( allmaps{i}.map , grframe, param.sigma_frac_norm, param.num_norm_iters, algtype , param.tol );
+        norm_maps{i}.map = maps{i};
     elseif ( param.normalizationType == 2 )
         mymessage(param,' using graph-based scheme\n');
-        algtype = 1;
-        [norm_maps{i}.map,tmp] = graphsalapply( allmaps{i}.map , grframe, param.sigma_frac_norm, param.num_norm_iters, algtype , param.tol );
+        norm_maps{i}.map = maps{i};
     else
         mymessage(param,' using global - mean local maxima scheme.\n');
-        norm_maps{i}.map = maxNormalizeStdGBVS( mat2gray(imresize(allmaps{i}.map,param.salmapsize, 'bicubic')) );
+        norm_maps{i}.map = stack(:,:,i);
     end
     norm_maps{i}.maptype = allmaps{i}.maptype;
 end
@@ -143,10 +178,12 @@ for fmapi = 1 : length(mapnames)
       mymessage(param,'Performing additional top-level feature map normalization.\n');
       if ( param.normalizationType == 1 )
           algtype = 4;
-          [cmaps{fmapi},tmp] = graphsalapply( cmaps{fmapi} , grframe, param.sigma_frac_norm, param.num_norm_iters, algtype , param.tol );
+          [cmaps{fmapi},tmp] = graphsalapply( cmaps{fmapi} , grframe, param.sigma_frac_norm, param.num_norm_iters, algtype , param.tol , param.eigAccel , param.precision );
+          eigIters = eigIters + tmp;
       elseif ( param.normalizationType == 2 )
           algtype = 1;
-          [cmaps{fmapi},tmp] = graphsalapply( cmaps{fmapi} , grframe, param.sigma_frac_norm, param.num_norm_iters, algtype , param.tol );
+          [cmaps{fmapi},tmp] = graphsalapply( cmaps{fmapi} , grframe, param.sigma_frac_norm, param.num_norm_iters, algtype , param.tol , param.eigAccel , param.precision );
+          eigIters = eigIters + tmp;
       else
         cmaps{fmapi} = maxNormalizeStdGBVS( cmaps{fmapi} );
       end
@@ -222,6 +259,7 @@ out.map_types = map_types;
 out.intermed_maps = intermed_maps;
 out.rawfeatmaps = rawfeatmaps;
 out.paramsUsed = param;
+out.eigIters = eigIters;
 if ( param.saveInputImage )
     out.inputimg = img;
 end
@@ -99,6 +99,15 @@ p.num_norm_iters = 1;             % number of normalization iterations in GBVS -
 p.tol = .0001;                    % tol controls a stopping rule on the computation of the equilibrium distribution (principal eigenvector)
                                   % the higher it is, the faster the algorithm runs, but the more approximate it becomes.
                                   % it is used by algsrc/principalEigenvectorRaw.m - default .0001
+
+p.eigAccel = 0;                   % use value '1' to compute the equilibrium distributions by extrapolated power
+                                  % iteration (needs the compiled mexMarkovEquilibrium): it converges to the same
+                                  % distributions in fewer iterations. out.eigIters reports the # of iterations either way - default 0
+
+p.precision = 'double';           % 'single' stores the P x P markov matrices in single precision (half the memory; the weights
+                                  % are still computed in double by the mex functions). 'validate' computes the map in both
+                                  % precisions and reports the largest difference of the master maps in out.precisionDeviation
+                                  % (out is the double one) - default 'double'
                                   
 
 p.cyclic_type = 2;                % this should *not* be changed (non-cyclic boundary rules)
@@ -0,0 +1,476 @@
+#include <math.h>
+#include <limits>
+#include <algorithm>
+
+#include "gbvs.h"
+#include "gbvsKernels.h"
+#include "mapPyramid.h"
+
+// see partitionindex.m : bin (0-based) of each of N indices split into M bins
+static std::vector<int> partitionindex(int N, int M) {
+  int binsize = N / M;
+  int leftover = N - binsize * M;
+  std::vector<int> pad(M, 0), ix;
+  pad[0] = leftover / 2;
+  pad[M-1] = (leftover + 1) / 2;
+  for (int i = 0; i < M; i++)
+    for (int j = 0; j < binsize + pad[i]; j++)
+      ix.push_back(i);
+  return ix;
+}
+
+// squared distance along one axis of length n (see simpledistance.m)
+static int axisdistance(int a, int b, int n, int cyclic_type) {
+  int d = abs(a - b);
+  if (cyclic_type == 1)
+    d = std::min(d, abs(d - n));
+  return d * d;
+}
+
+// see simpledistance.m : squared distance between column-major indices
+static double simpledistance(int p, int q, int rows, int cols, int cyclic_type) {
+  return (double)(axisdistance(p % rows, q % rows, rows, cyclic_type) +
+                  axisdistance(p / rows, q / rows, cols, cyclic_type));
+}
+
+void mat2gray(double* A, int N) {
+  double mn = A[0], mx = A[0];
+  for (int i = 1; i < N; i++) {
+    mn = std::min(mn, A[i]);
+    mx = std::max(mx, A[i]);
+  }
+  double delta = (mx == mn) ? 1.0 : 1.0 / (mx - mn);
+  double shift = (mx == mn) ? 0.0 : mn;
+  for (int i = 0; i < N; i++)
+    A[i] = std::max(0.0, std::min((A[i] - shift) * delta, 1.0));
+}
+
+// nodes of the multiresolution graph (getDims, namenodes)
+struct NodeLayout {
+  int K;
+  std::vector<int> dr, dc, d, offsets;
+  // rowsOf[i][j] : rows of the original map covered by row j of scale i
+  std::vector<std::vector<std::vector<int> > > rowsOf, colsOf;
+};
+
+// fills everything in the frame but the distances, and the node layout
+static void layoutNodes(int rows, int cols, const std::vector<int>& multilevels,
+                        GBVSFrame& frame, NodeLayout& L) {
+  frame.rows = rows;
+  frame.cols = cols;
+  frame.multilevels = multilevels;
+
+  // getDims
+  int max_delta = 0;
+  for (size_t i = 0; i < multilevels.size(); i++)
+    max_delta = std::max(max_delta, multilevels[i]);
+  std::vector<int> hs(max_delta + 1), ws(max_delta + 1);
+  hs[0] = rows; ws[0] = cols;
+  for (int i = 1; i <= max_delta; i++)
+    subsampledSize(hs[i-1], ws[i-1], hs[i], ws[i]);
+  const int K = L.K = 1 + (int)multilevels.size();
+  L.dr.resize(K); L.dc.resize(K);
+  L.dr[0] = rows; L.dc[0] = cols;
+  for (int i = 1; i < K; i++) {
+    L.dr[i] = hs[multilevels[i-1]];
+    L.dc[i] = ws[multilevels[i-1]];
+  }
+  frame.dims.resize(2 * K);
+  for (int i = 0; i < K; i++) {
+    frame.dims[i] = L.dr[i];
+    frame.dims[K + i] = L.dc[i];
+  }
+
+  // namenodes
+  L.d.resize(K); L.offsets.resize(K);
+  int P = 0;
+  for (int i = 0; i < K; i++) {
+    L.d[i] = L.dr[i] * L.dc[i];
+    L.offsets[i] = P;
+    P += L.d[i];
+  }
+  frame.P = P;
+
+  // makeLocationMap, as the location index of mexLocationIndex: location
+  // (r,c) is covered by one node per scale, in increasing order
+  const int N = rows * cols;
+  L.rowsOf.resize(K); L.colsOf.resize(K);
+  frame.lxi.assign(2 + (N + 1) + P + (size_t)N * K, 0);
+  int* Lp = &frame.lxi[2];
+  int* Lk = Lp + N + 1;
+  int* Li = Lk + P;
+  frame.lxi[0] = N;
+  frame.lxi[1] = P;
+  for (int l = 0; l <= N; l++) Lp[l] = l * K;
+  for (int i = 0; i < K; i++) {
+    std::vector<int> pr = partitionindex(rows, L.dr[i]);
+    std::vector<int> pc = partitionindex(cols, L.dc[i]);
+    L.rowsOf[i].resize(L.dr[i]);
+    L.colsOf[i].resize(L.dc[i]);
+    for (int r = 0; r < rows; r++) L.rowsOf[i][pr[r]].push_back(r);
+    for (int c = 0; c < cols; c++) L.colsOf[i][pc[c]].push_back(c);
+    for (int k = 0; k < L.dc[i]; k++)
+      for (int j = 0; j < L.dr[i]; j++)
+        Lk[L.offsets[i] + k * L.dr[i] + j] =
+            (int)(L.rowsOf[i][j].size() * L.colsOf[i][k].size());
+    for (int c = 0; c < cols; c++)
+      for (int r = 0; r < rows; r++)
+        Li[(size_t)(c * rows + r) * K + i] =
+            L.offsets[i] + pc[c] * L.dr[i] + pr[r];
+  }
+}
+
+// locations (indices into the original map) of each node, in the order of
+// makeLocationMap.m
+static std::vector<std::vector<int> > nodeLocations(const NodeLayout& L,
+                                                    int rows, int P) {
+  std::vector<std::vector<int> > locs(P);
+  for (int i = 0; i < L.K; i++) {
+    for (int k = 0; k < L.dc[i]; k++) {
+      for (int j = 0; j < L.dr[i]; j++) {
+        std::vector<int>& lst = locs[L.offsets[i] + k * L.dr[i] + j];
+        const std::vector<int>& xs = L.rowsOf[i][j];
+        const std::vector<int>& ys = L.colsOf[i][k];
+        for (size_t ii = 0; ii < xs.size(); ii++)
+          for (size_t jj = 0; jj < ys.size(); jj++)
+            lst.push_back(ys[jj] * rows + xs[ii]);
+      }
+    }
+  }
+  return locs;
+}
+
+void graphsalinit(int rows, int cols, const std::vector<int>& multilevels,
+                  int inter_type, int intra_type, int cyclic_type,
+                  GBVSFrame& frame) {
+  const double inf = std::numeric_limits<double>::infinity();
+  NodeLayout L;
+  layoutNodes(rows, cols, multilevels, frame, L);
+  const int K = L.K, P = frame.P;
+  frame.Sp.clear(); frame.Si.clear(); frame.Sd.clear();
+
+  // connectMatrix .* distanceMatrix
+  frame.D.assign((size_t)P * P, 0);
+  for (int i = 0; i < K; i++) {
+    double scale = (double)L.d[0] / L.d[i];
+    for (int a = 0; a < L.d[i]; a++) {
+      for (int b = 0; b < L.d[i]; b++) {
+        double dd = simpledistance(a, b, L.dr[i], L.dc[i], cyclic_type);
+        bool connected = (intra_type != 1) || (dd <= 1);
+        frame.D[(size_t)(L.offsets[i] + b) * P + L.offsets[i] + a] =
+            connected ? dd * scale : inf * dd * scale;
+      }
+    }
+  }
+  std::vector<std::vector<int> > locs = nodeLocations(L, rows, P);
+  for (int i1 = 0; i1 < K; i1++) {
+    for (int i2 = i1 + 1; i2 < K; i2++) {
+      for (int a = L.offsets[i1]; a < L.offsets[i1] + L.d[i1]; a++) {
+        const std::vector<int>& la = locs[a];
+        for (int b = L.offsets[i2]; b < L.offsets[i2] + L.d[i2]; b++) {
+          const std::vector<int>& lb = locs[b];
+          double mean_dist = 0;
+          bool shared = false;
+          for (size_t p = 0; p < la.size(); p++) {
+            for (size_t q = 0; q < lb.size(); q++) {
+              mean_dist += simpledistance(la[p], lb[q], rows, cols, cyclic_type);
+              shared = shared || (la[p] == lb[q]);
+            }
+          }
+          mean_dist /= (double)(la.size() * lb.size());
+          bool connected = (inter_type != 1) || shared;
+          double v = connected ? mean_dist : inf * mean_dist;
+          frame.D[(size_t)b * P + a] = v;
+          frame.D[(size_t)a * P + b] = v;
+        }
+      }
+    }
+  }
+}
+
+double graphsalMaxDistance(int rows, int cols, double sigma_frac,
+                           double weight_tol) {
+  if (weight_tol <= 0)
+    return std::numeric_limits<double>::infinity();
+  double sig = sigma_frac * (rows + cols) / 2.0;
+  return -2 * sig * sig * log(weight_tol);
+}
+
+// distances along one axis between the bins of two scales: the squared
+// distance on the same scale, or the mean squared distance between the
+// covered original rows (columns) across scales. Since the locations of a
+// node are the product of its rows and columns, the mean distance between
+// two nodes of distanceMatrix.m is the sum of the row and column means.
+static std::vector<double> axisTable(const std::vector<std::vector<int> >& binsR,
+                                     const std::vector<std::vector<int> >& binsC,
+                                     bool same, int n, int n0, int cyclic_type,
+                                     std::vector<char>& shared) {
+  const int R = (int)binsR.size(), C = (int)binsC.size();
+  std::vector<double> t((size_t)R * C);
+  shared.assign((size_t)R * C, 0);
+  for (int c = 0; c < C; c++) {
+    for (int r = 0; r < R; r++) {
+      if (same) {
+        t[(size_t)c * R + r] = axisdistance(r, c, n, cyclic_type);
+        shared[(size_t)c * R + r] = (r == c);
+        continue;
+      }
+      const std::vector<int>& a = binsR[r];
+      const std::vector<int>& b = binsC[c];
+      double s = 0;
+      for (size_t p = 0; p < a.size(); p++)
+        for (size_t q = 0; q < b.size(); q++)
+          s += axisdistance(a[p], b[q], n0, cyclic_type);
+      t[(size_t)c * R + r] = s / (double)(a.size() * b.size());
+      // bins are contiguous ranges
+      shared[(size_t)c * R + r] = a.front() <= b.back() && b.front() <= a.back();
+    }
+  }
+  return t;
+}
+
+void graphsalinitSparse(int rows, int cols, const std::vector<int>& multilevels,
+                        int inter_type, int intra_type, int cyclic_type,
+                        double max_dist, GBVSFrame& frame) {
+  NodeLayout L;
+  layoutNodes(rows, cols, multilevels, frame, L);
+  const int K = L.K;
+  frame.D.clear();
+  frame.Sp.assign(1, 0);
+  frame.Si.clear();
+  frame.Sd.clear();
+
+  // row / column distance tables for every (row scale, column scale) pair
+  std::vector<std::vector<double> > Rt(K * K), Ct(K * K);
+  std::vector<std::vector<char> > Rs(K * K), Cs(K * K);
+  for (int lc = 0; lc < K; lc++) {
+    for (int lr = 0; lr < K; lr++) {
+      Rt[lc * K + lr] = axisTable(L.rowsOf[lr], L.rowsOf[lc], lr == lc, L.dr[lr],
+                                  rows, cyclic_type, Rs[lc * K + lr]);
+      Ct[lc * K + lr] = axisTable(L.colsOf[lr], L.colsOf[lc], lr == lc, L.dc[lr],
+                                  cols, cyclic_type, Cs[lc * K + lr]);
+    }
+  }
+
+  std::vector<int> ks, js;
+  for (int lc = 0; lc < K; lc++) {
+    for (int n = 0; n < L.d[lc]; n++) {
+      const int j = n % L.dr[lc], k = n / L.dr[lc];
+      for (int lr = 0; lr < K; lr++) {
+        const bool same = (lr == lc);
+        // distances on one scale are in units of the original map
+        const double scale = same ? (double)L.d[0] / L.d[lr] : 1.0;
+        const int R = L.dr[lr], C = L.dc[lr];
+        const double* rt = &Rt[lc * K + lr][(size_t)j * R];
+        const double* ct = &Ct[lc * K + lr][(size_t)k * C];
+        const char* rs = &Rs[lc * K + lr][(size_t)j * R];
+        const char* cs = &Cs[lc * K + lr][(size_t)k * C];
+        ks.clear(); js.clear();
+        for (int kk = 0; kk < C; kk++)
+          if (ct[kk] * scale <= max_dist) ks.push_back(kk);
+        for (int jj = 0; jj < R; jj++)
+          if (rt[jj] * scale <= max_dist) js.push_back(jj);
+        for (size_t a = 0; a < ks.size(); a++) {
+          for (size_t b = 0; b < js.size(); b++) {
+            const int kk = ks[a], jj = js[b];
+            double dd = (rt[jj] + ct[kk]) * scale;
+            if (dd > max_dist)
+              continue;
+            bool connected = same ? (intra_type != 1) || (rt[jj] + ct[kk] <= 1)
+                                  : (inter_type != 1) || (rs[jj] && cs[kk]);
+            if (!connected)
+              continue;
+            frame.Si.push_back(L.offsets[lr] + kk * R + jj);
+            frame.Sd.push_back(dd);
+          }
+        }
+      }
+      frame.Sp.push_back((int)frame.Si.size());
+    }
+  }
+}
+
+int principalEigenvectorRaw(const double* markovA, int P, double tol,
+                            double* v, bool accel, const double* v0) {
+  DenseMarkov<double> M = { markovA, P };
+  if (accel)
+    return extrapolatedPowerIteration(M, P, tol, v, v0);
+  return powerIteration(M, P, tol, v);
+}
+
+int principalEigenvectorSparse(const int* Jc, const int* Ir,
+                               const double* markovA, int P, double tol,
+                               double* v, bool accel, const double* v0) {
+  SparseMarkov<double> M = { Jc, Ir, markovA, P };
+  if (accel)
+    return extrapolatedPowerIteration(M, P, tol, v, v0);
+  return powerIteration(M, P, tol, v);
+}
+
+GBVSFrameView frameView(const GBVSFrame& frame) {
+  GBVSFrameView view;
+  view.rows = frame.rows;
+  view.cols = frame.cols;
+  view.numMultilevels = (int)frame.multilevels.size();
+  view.multilevels = frame.multilevels.empty() ? 0 : &frame.multilevels[0];
+  view.dims = &frame.dims[0];
+  view.P = frame.P;
+  view.D = frame.D.empty() ? 0 : &frame.D[0];
+  view.Sp = frame.Sp.empty() ? 0 : &frame.Sp[0];
+  view.Si = frame.Si.empty() ? 0 : &frame.Si[0];
+  view.Sd = frame.Sd.empty() ? 0 : &frame.Sd[0];
+  view.lxi = &frame.lxi[0];
+  return view;
+}
+
+int graphsalapply(const double* A, const GBVSFrame& frame, double sigma_frac,
+                  int num_iters, int algtype, double tol, double* Anorm,
+                  bool accel, GBVSPrecision precision) {
+  return graphsalapply(A, frameView(frame), sigma_frac, num_iters, algtype,
+                       tol, Anorm, accel, precision);
+}
+
+// Dw = exp(-D/(2 sig^2)) of a dense frame, or nothing for a sparse frame
+// (whose weights are computed on the fly)
+template <class TM>
+static void weightMatrix(const GBVSFrameView& frame, double sig,
+                         std::vector<TM>& Dw) {
+  if (!frame.D)
+    return;
+  Dw.resize((size_t)frame.P * frame.P);
+  for (size_t i = 0; i < Dw.size(); i++)
+    Dw[i] = (TM)exp(-1 * frame.D[i] / (2 * sig * sig));
+}
+
+// # of entries of the markov matrix of frame
+static size_t markovSize(const GBVSFrameView& frame) {
+  return frame.D ? (size_t)frame.P * frame.P : (size_t)frame.Sp[frame.P];
+}
+
+// formMapPyramid, already in the linear order of the nodes (the AL of
+// mexArrangeLinear): each level is scaled to [0,1] in place
+static void nodeValues(const double* A, MapPyramid& pyr) {
+  const double my_eps = 1e-12;
+  pyr.build(A);
+  for (int i = 0; i < pyr.numLevels(); i++) {
+    double* map = pyr.level(i);
+    int n = pyr.rows(i) * pyr.cols(i);
+    mat2gray(map, n);
+    if (*std::max_element(map, map + n) == 0)
+      for (int j = 0; j < n; j++) map[j] += my_eps;
+  }
+}
+
+// the num_iters equilibria of graphsalapply, with markov matrices of TM in
+// MM (markovSize entries) and the weights Dw of weightMatrix; AL is replaced
+// by the last one
+template <class TM>
+static int markovIterations(double* AL, const GBVSFrameView& frame, double sig,
+                            const TM* Dw, TM* MM, int num_iters, int algtype,
+                            double tol, bool accel) {
+  const int P = frame.P;
+  int iters = 0;
+  // with accel, each iteration after the first starts from the previous
+  // equilibrium (which is also its AL, hence v0 may alias v)
+  const double* v0 = 0;
+  if (!frame.D) {
+    // sparse graph: the weights are computed from the distances on the fly
+    const int* Jc = frame.Sp;
+    const int* Ir = frame.Si;
+    SparseMarkov<TM> M = { Jc, Ir, MM, P };
+    for (int i = 0; i < num_iters; i++) {
+      assignWeightsNormalizedSparse(AL, Jc, Ir, frame.Sd, sig, MM, P, algtype);
+      iters += accel ? extrapolatedPowerIteration(M, P, tol, AL, v0)
+                     : powerIteration(M, P, tol, AL);
+      v0 = AL;
+    }
+  } else {
+    // markov matrix and its principal eigenvector (mexMarkovEquilibrium)
+    for (int i = 0; i < num_iters; i++) {
+      iters += markovEquilibrium(AL, Dw, MM, P, algtype, tol, AL, accel, v0);
+      v0 = AL;
+    }
+  }
+  return iters;
+}
+
+template <class TM>
+static int graphsalapplyT(const double* A, const GBVSFrameView& frame,
+                          double sigma_frac, int num_iters, int algtype,
+                          double tol, double* Anorm, bool accel) {
+  MapPyramid pyr(frame);
+  nodeValues(A, pyr);
+  double* AL = pyr.data();
+
+  // get a weight matrix between nodes based on distance matrix
+  double sig = sigma_frac * (frame.rows + frame.cols) / 2.0;
+  std::vector<TM> Dw, MM(markovSize(frame));
+  weightMatrix(frame, sig, Dw);
+  int iters = markovIterations(AL, frame, sig, Dw.empty() ? 0 : &Dw[0],
+                               &MM[0], num_iters, algtype, tol, accel);
+
+  // collapse multiresolution representation back onto one scale
+  gatherOverScales(AL, frame.lxi, Anorm);
+  return iters;
+}
+
+int graphsalapply(const double* A, const GBVSFrameView& frame,
+                  double sigma_frac, int num_iters, int algtype, double tol,
+                  double* Anorm, bool accel, GBVSPrecision precision) {
+  if (algtype == 4) {
+    const int N = frame.rows * frame.cols;
+    for (int i = 0; i < N; i++) Anorm[i] = pow(A[i], 1.5);
+    return 1;
+  }
+  if (precision == GBVS_SINGLE)
+    return graphsalapplyT<float>(A, frame, sigma_frac, num_iters, algtype,
+                                 tol, Anorm, accel);
+  return graphsalapplyT<double>(A, frame, sigma_frac, num_iters, algtype, tol,
+                                Anorm, accel);
+}
+
+template <class TM>
+static int graphsalapplyBatchT(const double* As, int M,
+                               const GBVSFrameView& frame, double sigma_frac,
+                               int num_iters, int algtype, double tol,
+                               double* Anorms, bool accel) {
+  const size_t N = (size_t)frame.rows * frame.cols;
+  double sig = sigma_frac * (frame.rows + frame.cols) / 2.0;
+  std::vector<TM> Dw;
+  weightMatrix(frame, sig, Dw);
+  const TM* DwP = Dw.empty() ? 0 : &Dw[0];
+  int iters = 0, m;
+
+  // one map per thread at a time, each with its own pyramid and markov
+  // matrix; the kernels called from here run single-threaded
+#pragma omp parallel reduction(+:iters)
+  {
+    MapPyramid pyr(frame);
+    std::vector<TM> MM(markovSize(frame));
+#pragma omp for schedule(dynamic)
+    for (m = 0; m < M; m++) {
+      nodeValues(As + m * N, pyr);
+      double* AL = pyr.data();
+      iters += markovIterations(AL, frame, sig, DwP, &MM[0], num_iters,
+                                algtype, tol, accel);
+      gatherOverScales(AL, frame.lxi, Anorms + m * N);
+    }
+  }
+  return iters;
+}
+
+int graphsalapplyBatch(const double* As, int M, const GBVSFrameView& frame,
+                       double sigma_frac, int num_iters, int algtype,
+                       double tol, double* Anorms, bool accel,
+                       GBVSPrecision precision) {
+  if (algtype == 4) {
+    const size_t N = (size_t)frame.rows * frame.cols * M;
+    for (size_t i = 0; i < N; i++) Anorms[i] = pow(As[i], 1.5);
+    return M;
+  }
+  if (precision == GBVS_SINGLE)
+    return graphsalapplyBatchT<float>(As, M, frame, sigma_frac, num_iters,
+                                      algtype, tol, Anorms, accel);
+  return graphsalapplyBatchT<double>(As, M, frame, sigma_frac, num_iters,
+                                     algtype, tol, Anorms, accel);
+}
@@ -0,0 +1,107 @@
+#ifndef GBVS_NATIVE_H
+#define GBVS_NATIVE_H
+
+#include <vector>
+
+// Native (MATLAB-free) implementation of graphsalinit / graphsalapply, built
+// on the same kernels as the mex functions in ../algsrc and ../saltoolbox.
+// Maps are column-major double arrays (rows x cols), as in MATLAB.
+
+// the 'frame' of graphsalinit.m: constants shared by every graphsalapply call
+// on maps of one size
+struct GBVSFrame {
+  int rows, cols;                // size of the maps the frame applies to
+  std::vector<int> multilevels;  // extra pyramid levels (binary orders smaller)
+  std::vector<double> dims;      // K x 2   dimensions of each scale
+  int P;                         // # of nodes over all scales
+  std::vector<double> D;         // P x P   distance matrix (inf: not connected)
+  // sparse alternative to D, filled by graphsalinitSparse (D is then empty):
+  // the nodes connected to node c are Si[ Sp[c] .. Sp[c+1]-1 ], at
+  // distances Sd[ Sp[c] .. Sp[c+1]-1 ]
+  std::vector<int> Sp, Si;
+  std::vector<double> Sd;
+  std::vector<int> lxi;          // location index (see mexLocationIndex)
+};
+
+// read-only view of the arrays of a frame, which may be owned by a GBVSFrame
+// or mapped from a frame cache file (see gbvsCache.h)
+struct GBVSFrameView {
+  int rows, cols;
+  int numMultilevels;
+  const int* multilevels;
+  const double* dims;
+  int P;
+  const double* D;               // 0 for a sparse frame
+  const int *Sp, *Si;
+  const double* Sd;
+  const int* lxi;
+};
+
+GBVSFrameView frameView(const GBVSFrame& frame);
+
+// inter_type :  1 => only same-location neighbor
+//               2 => everywhere inter-scale
+// intra_type :  1 => only neighbor
+//               2 => everywhere
+// cyclic_type : 1 => cyclic boundary rules
+//               2 => non-cyclic boundaries
+void graphsalinit(int rows, int cols, const std::vector<int>& multilevels,
+                  int inter_type, int intra_type, int cyclic_type,
+                  GBVSFrame& frame);
+
+// same graph as graphsalinit, but only the edges of distance <= max_dist are
+// kept, in compressed columns: memory is O(P * edges per node) instead of
+// O(P^2), and the weights are computed on the fly by graphsalapply
+void graphsalinitSparse(int rows, int cols, const std::vector<int>& multilevels,
+                        int inter_type, int intra_type, int cyclic_type,
+                        double max_dist, GBVSFrame& frame);
+
+// distance beyond which the edge weight exp(-D/(2 sig^2)) of a graphsalapply
+// call with this sigma_frac falls below weight_tol (relative to a self edge)
+double graphsalMaxDistance(int rows, int cols, double sigma_frac,
+                           double weight_tol);
+
+// element type of the markov matrices of graphsalapply. GBVS_SINGLE halves
+// their memory (and the time of the memory-bound products); the weights are
+// still computed and summed in double (see gbvsKernels.h)
+enum GBVSPrecision { GBVS_DOUBLE, GBVS_SINGLE };
+
+// Anorm = graphsalapply( A , frame , sigma_frac , num_iters , algtype , tol )
+// A and Anorm are frame.rows x frame.cols. Returns the total number of
+// power iterations (1 for algtype 4). With accel, the equilibria are found by
+// extrapolated power iteration, warm-started from the previous one when
+// num_iters > 1: same maps to within tol, in fewer iterations.
+int graphsalapply(const double* A, const GBVSFrame& frame, double sigma_frac,
+                  int num_iters, int algtype, double tol, double* Anorm,
+                  bool accel = false, GBVSPrecision precision = GBVS_DOUBLE);
+int graphsalapply(const double* A, const GBVSFrameView& frame,
+                  double sigma_frac, int num_iters, int algtype, double tol,
+                  double* Anorm, bool accel = false,
+                  GBVSPrecision precision = GBVS_DOUBLE);
+
+// graphsalapply on M maps of the frame's size in one call: As and Anorms hold
+// the maps one after the other, frame.rows * frame.cols values each. Dw is
+// computed once for all of them, and the maps run in parallel (OpenMP), one
+// per thread with its own markov matrix (memory: threads x P^2 entries).
+// Returns the total number of power iterations of all the maps.
+int graphsalapplyBatch(const double* As, int M, const GBVSFrameView& frame,
+                       double sigma_frac, int num_iters, int algtype,
+                       double tol, double* Anorms, bool accel = false,
+                       GBVSPrecision precision = GBVS_DOUBLE);
+
+// computes the principal eigenvector of a P x P markov matrix; v is P x 1.
+// With accel, by extrapolated power iteration started from v0 (if given).
+int principalEigenvectorRaw(const double* markovA, int P, double tol,
+                            double* v, bool accel = false,
+                            const double* v0 = 0);
+
+// same for a markov matrix stored in compressed columns (see GBVSFrame::Sp)
+int principalEigenvectorSparse(const int* Jc, const int* Ir,
+                               const double* markovA, int P, double tol,
+                               double* v, bool accel = false,
+                               const double* v0 = 0);
+
+// mat2gray: rescales A to [0,1] (clamps it when A is constant)
+void mat2gray(double* A, int N);
+
+#endif
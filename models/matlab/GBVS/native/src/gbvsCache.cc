@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "gbvsCache.h"
+#include "gbvsKernels.h"
+
+// num2str of a row of nonnegative integers, as MATLAB prints it: each number
+// right-aligned in (max # of digits + 2) characters, leading blanks trimmed
+static std::string num2str(const std::vector<int>& v) {
+  std::vector<std::string> s(v.size());
+  size_t width = 0;
+  for (size_t i = 0; i < v.size(); i++) {
+    std::ostringstream os;
+    os << v[i];
+    s[i] = os.str();
+    width = std::max(width, s[i].size());
+  }
+  std::string out;
+  for (size_t i = 0; i < v.size(); i++) {
+    if (i > 0)
+      out += std::string(width + 2 - s[i].size(), ' ');
+    out += s[i];
+  }
+  return out;
+}
+
+std::string frameCacheName(int rows, int cols,
+                           const std::vector<int>& multilevels,
+                           int inter_type, int intra_type, int cyclic_type,
+                           double max_dist) {
+  // sprintf('%s__m%s__%s',num2str(salmapsize),num2str(multilevels),
+  //         num2str(cyclic_type)) with blanks replaced, as in initGBVS.m
+  std::vector<int> size(2);
+  size[0] = rows; size[1] = cols;
+  std::ostringstream os;
+  os << num2str(size) << "__m" << num2str(multilevels) << "__" << cyclic_type;
+  if (inter_type != 2 || intra_type != 2)
+    os << "__t" << inter_type << intra_type;
+  // all digits of max_dist: distances that print alike at the default
+  // precision of 6 digits must not share a (sparse) frame
+  if (max_dist > 0)
+    os << "__d" << std::setprecision(17) << max_dist;
+  std::string name = os.str();
+  for (size_t i = 0; i < name.size(); i++)
+    if (name[i] == ' ') name[i] = '_';
+  return name + ".gbvsframe";
+}
+
+static int64_t alignUp(int64_t n) {
+  return (n + GBVS_CACHE_ALIGN - 1) / GBVS_CACHE_ALIGN * GBVS_CACHE_ALIGN;
+}
+
+static const size_t elemSize[CACHE_NUM_ARRAYS] = {
+  sizeof(int32_t), sizeof(double), sizeof(double), sizeof(int32_t),
+  sizeof(int32_t), sizeof(double), sizeof(int32_t)
+};
+
+bool saveFrame(const std::string& path, const GBVSFrame& frame) {
+  GBVSCacheHeader h;
+  memset(&h, 0, sizeof(h));
+  strncpy(h.magic, GBVS_CACHE_MAGIC, sizeof(h.magic));
+  h.version = GBVS_CACHE_VERSION;
+  h.byteOrder = GBVS_CACHE_BYTE_ORDER;
+  h.rows = frame.rows;
+  h.cols = frame.cols;
+  h.P = frame.P;
+  h.N = frame.rows * frame.cols;
+  h.numMultilevels = (int32_t)frame.multilevels.size();
+  h.K = h.numMultilevels + 1;
+
+  std::vector<int32_t> multilevels(frame.multilevels.begin(),
+                                   frame.multilevels.end());
+  std::vector<int32_t> Sp(frame.Sp.begin(), frame.Sp.end());
+  std::vector<int32_t> Si(frame.Si.begin(), frame.Si.end());
+  const void* data[CACHE_NUM_ARRAYS] = {
+    multilevels.empty() ? 0 : &multilevels[0], &frame.dims[0],
+    frame.D.empty() ? 0 : &frame.D[0], Sp.empty() ? 0 : &Sp[0],
+    Si.empty() ? 0 : &Si[0], frame.Sd.empty() ? 0 : &frame.Sd[0],
+    &frame.lxi[0]
+  };
+  h.count[CACHE_MULTILEVELS] = multilevels.size();
+  h.count[CACHE_DIMS] = frame.dims.size();
+  h.count[CACHE_D] = frame.D.size();
+  h.count[CACHE_SP] = Sp.size();
+  h.count[CACHE_SI] = Si.size();
+  h.count[CACHE_SD] = frame.Sd.size();
+  h.count[CACHE_LXI] = frame.lxi.size();
+  int64_t pos = alignUp(sizeof(h));
+  for (int a = 0; a < CACHE_NUM_ARRAYS; a++) {
+    h.offset[a] = pos;
+    pos = alignUp(pos + h.count[a] * (int64_t)elemSize[a]);
+  }
+  h.fileSize = pos;
+
+  // a temporary name unique to this call (mkstemp), also between the threads
+  // of a process and the hosts that share a cache directory
+  std::string tmpName = path + ".tmpXXXXXX";
+  std::vector<char> tmp(tmpName.begin(), tmpName.end());
+  tmp.push_back('\0');
+  int fd = mkstemp(&tmp[0]);
+  if (fd < 0)
+    return false;
+  tmpName = &tmp[0];
+  // mkstemp creates the file readable by its owner only; the cache is shared
+  fchmod(fd, 0644);
+  FILE* f = fdopen(fd, "wb");
+  if (!f) {
+    ::close(fd);
+    remove(tmpName.c_str());
+    return false;
+  }
+  static const char zeros[GBVS_CACHE_ALIGN] = { 0 };
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+  pos = sizeof(h);
+  for (int a = 0; a < CACHE_NUM_ARRAYS && ok; a++) {
+    ok = fwrite(zeros, 1, h.offset[a] - pos, f) == (size_t)(h.offset[a] - pos);
+    if (ok && h.count[a] > 0)
+      ok = fwrite(data[a], elemSize[a], h.count[a], f) == (size_t)h.count[a];
+    pos = h.offset[a] + h.count[a] * elemSize[a];
+  }
+  if (ok)
+    ok = fwrite(zeros, 1, h.fileSize - pos, f) == (size_t)(h.fileSize - pos);
+  ok = (fclose(f) == 0) && ok;
+  if (ok)
+    ok = rename(tmpName.c_str(), path.c_str()) == 0;
+  if (!ok)
+    remove(tmpName.c_str());
+  return ok;
+}
+
+MappedFrame::MappedFrame() : mBase(0), mSize(0) {
+  memset(&mView, 0, sizeof(mView));
+}
+
+MappedFrame::~MappedFrame() {
+  close();
+}
+
+void MappedFrame::close() {
+  if (mBase)
+    munmap(mBase, mSize);
+  mBase = 0;
+  mSize = 0;
+  memset(&mView, 0, sizeof(mView));
+}
+
+// checks that the arrays of h lie in a file of size bytes and that their
+// sizes agree with each other
+static bool validHeader(const GBVSCacheHeader& h, size_t size) {
+  if (memcmp(h.magic, GBVS_CACHE_MAGIC, sizeof(GBVS_CACHE_MAGIC)) != 0 ||
+      h.version != GBVS_CACHE_VERSION || h.byteOrder != GBVS_CACHE_BYTE_ORDER ||
+      h.fileSize != (int64_t)size)
+    return false;
+  // count * elemSize is compared by division, it may overflow for a corrupt
+  // count
+  for (int a = 0; a < CACHE_NUM_ARRAYS; a++)
+    if (h.count[a] < 0 || h.offset[a] < (int64_t)sizeof(h) ||
+        h.offset[a] % GBVS_CACHE_ALIGN != 0 || h.offset[a] > h.fileSize ||
+        h.count[a] > (h.fileSize - h.offset[a]) / (int64_t)elemSize[a])
+      return false;
+  const int64_t P = h.P;
+  bool sparse = h.count[CACHE_D] == 0;
+  return h.P > 0 && h.K == h.numMultilevels + 1 &&
+         h.count[CACHE_MULTILEVELS] == h.numMultilevels &&
+         h.count[CACHE_DIMS] == 2 * h.K &&
+         h.N == (int64_t)h.rows * h.cols &&
+         h.count[CACHE_LXI] >= 2 + h.N + 1 + P &&
+         (sparse ? h.count[CACHE_SP] == P + 1 &&
+                   h.count[CACHE_SI] == h.count[CACHE_SD]
+                 : h.count[CACHE_D] == P * P);
+}
+
+bool MappedFrame::open(const std::string& path) {
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  void* base = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(GBVSCacheHeader))
+    base = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED)
+    return false;
+  mBase = base;
+  mSize = st.st_size;
+
+  const GBVSCacheHeader& h = *(const GBVSCacheHeader*)mBase;
+  const char* p = (const char*)mBase;
+  if (!validHeader(h, mSize)) {
+    close();
+    return false;
+  }
+  const int32_t* lxi = (const int32_t*)(p + h.offset[CACHE_LXI]);
+  if (lxi[0] != h.N ||
+      !validLocationIndex(lxi, h.count[CACHE_LXI], h.P)) {
+    close();
+    return false;
+  }
+  if (h.count[CACHE_D] == 0) {
+    const int32_t* Sp = (const int32_t*)(p + h.offset[CACHE_SP]);
+    if (Sp[0] != 0 || Sp[h.P] != h.count[CACHE_SI]) {
+      close();
+      return false;
+    }
+  }
+
+  mView.rows = h.rows;
+  mView.cols = h.cols;
+  mView.numMultilevels = h.numMultilevels;
+  mView.multilevels = (const int*)(p + h.offset[CACHE_MULTILEVELS]);
+  mView.dims = (const double*)(p + h.offset[CACHE_DIMS]);
+  mView.P = h.P;
+  mView.D = h.count[CACHE_D] ? (const double*)(p + h.offset[CACHE_D]) : 0;
+  mView.Sp = (const int*)(p + h.offset[CACHE_SP]);
+  mView.Si = (const int*)(p + h.offset[CACHE_SI]);
+  mView.Sd = (const double*)(p + h.offset[CACHE_SD]);
+  mView.lxi = lxi;
+  return true;
+}
+
+bool loadOrInitFrame(const std::string& cache_dir, int rows, int cols,
+                     const std::vector<int>& multilevels, int inter_type,
+                     int intra_type, int cyclic_type, double max_dist,
+                     MappedFrame& frame) {
+  std::string path = cache_dir + "/" +
+      frameCacheName(rows, cols, multilevels, inter_type, intra_type,
+                     cyclic_type, max_dist);
+  if (frame.open(path))
+    return true;
+
+  GBVSFrame built;
+  if (max_dist > 0)
+    graphsalinitSparse(rows, cols, multilevels, inter_type, intra_type,
+                       cyclic_type, max_dist, built);
+  else
+    graphsalinit(rows, cols, multilevels, inter_type, intra_type, cyclic_type,
+                 built);
+  return saveFrame(path, built) && frame.open(path);
+}
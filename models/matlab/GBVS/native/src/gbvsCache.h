@@ -0,0 +1,84 @@
+#ifndef GBVS_CACHE_H
+#define GBVS_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "gbvs.h"
+
+// Binary cache of GBVS frames. A frame is built and written once per map size
+// and parameter set, then mapped read-only by every later run: processes that
+// map the same file share its pages, so the graphsalinit time and the frame
+// memory are paid once per machine (or once per fleet, with a shared cache
+// directory). algsrc/loadFrameCache.m and saveFrameCache.m read and write the
+// same files from MATLAB.
+//
+// File layout, in the byte order of the writer: a GBVSCacheHeader, then the
+// arrays multilevels (int32), dims, D, Sp (int32), Si (int32), Sd (double)
+// and lxi (int32), column-major, each at a 64-byte aligned offset. Absent
+// arrays (D of a sparse frame, Sp/Si/Sd of a dense one) have 0 elements.
+
+#define GBVS_CACHE_MAGIC "GBVSFRM"
+#define GBVS_CACHE_VERSION 2
+#define GBVS_CACHE_BYTE_ORDER 0x01020304
+#define GBVS_CACHE_ALIGN 64
+
+enum { CACHE_MULTILEVELS, CACHE_DIMS, CACHE_D, CACHE_SP, CACHE_SI, CACHE_SD,
+       CACHE_LXI, CACHE_NUM_ARRAYS };
+
+struct GBVSCacheHeader {
+  char magic[8];                       // GBVS_CACHE_MAGIC
+  int32_t version;                     // GBVS_CACHE_VERSION
+  int32_t byteOrder;                   // GBVS_CACHE_BYTE_ORDER as written
+  int32_t rows, cols, P, N;            // N = rows * cols
+  int32_t numMultilevels, K;
+  int64_t offset[CACHE_NUM_ARRAYS];    // in bytes from the start of the file
+  int64_t count[CACHE_NUM_ARRAYS];     // # of elements
+  int64_t fileSize;
+};
+
+// name of the cache file of a frame. For the graph of initGBVS.m (inter and
+// intra type 2, dense) it is the name of its .mat cache with the extension
+// .gbvsframe, e.g. 24__32__m2__3__2.gbvsframe, so MATLAB and native runs
+// share the files; other types and sparse frames (max_dist > 0) get suffixes.
+std::string frameCacheName(int rows, int cols,
+                           const std::vector<int>& multilevels,
+                           int inter_type, int intra_type, int cyclic_type,
+                           double max_dist = 0);
+
+// writes frame to path through a temporary file renamed into place, so that
+// concurrent writers and readers never see a partial file. false on error
+bool saveFrame(const std::string& path, const GBVSFrame& frame);
+
+// a frame cache file mapped read-only
+class MappedFrame {
+ public:
+  MappedFrame();
+  ~MappedFrame();
+
+  // maps path; false if it cannot be read or is not a valid frame file
+  bool open(const std::string& path);
+  void close();
+  bool isOpen() const { return mBase != 0; }
+  const GBVSFrameView& view() const { return mView; }
+
+ private:
+  MappedFrame(const MappedFrame&);
+  MappedFrame& operator=(const MappedFrame&);
+
+  void* mBase;
+  size_t mSize;
+  GBVSFrameView mView;
+};
+
+// maps the frame of these graphsalinit parameters from cache_dir, building
+// and saving it first if it is not cached yet. max_dist > 0 makes a sparse
+// frame (see graphsalinitSparse). false if the frame cannot be saved or mapped
+bool loadOrInitFrame(const std::string& cache_dir, int rows, int cols,
+                     const std::vector<int>& multilevels, int inter_type,
+                     int intra_type, int cyclic_type, double max_dist,
+                     MappedFrame& frame);
+
+#endif
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "gbvs.h"
+#include "gbvsCache.h"
+#include "gbvsKernels.h"
+
+using namespace std;
+
+// Checks the variants of graphsalapply against each other on 24x32 maps (the
+// default map size of gbvs.m): sparse against dense frames, single against
+// double precision, the batch against single maps, frames mapped from a cache
+// file against the built ones, extrapolated against plain power iteration,
+// and gatherOverScales (lxi) against sumOverScales (the lx of
+// makeLocationMap.m). Exits with 1 on a failure.
+
+static const int ROWS = 24, COLS = 32;
+
+static int failures = 0;
+
+// max. |a - b| relative to the range of a
+static double difference(const vector<double>& a, const vector<double>& b) {
+  double err = 0, range = 0;
+  for (size_t i = 0; i < a.size(); i++) {
+    err = max(err, fabs(a[i] - b[i]));
+    range = max(range, fabs(a[i]));
+  }
+  return range > 0 ? err / range : (err > 0 ? 1 : 0);
+}
+
+static void report(const string& what, double diff, double limit) {
+  const bool ok = diff <= limit;
+  if (!ok)
+    failures++;
+  cout << (ok ? "ok   " : "FAIL ") << what << ": relative difference " << diff
+       << " (limit " << limit << ")" << endl;
+}
+
+static void report(const string& what, bool ok) {
+  if (!ok)
+    failures++;
+  cout << (ok ? "ok   " : "FAIL ") << what << endl;
+}
+
+// a smooth map with a few bumps and some noise, as a feature map
+static vector<double> testMap(int seed) {
+  srand(seed);
+  vector<double> A(ROWS * COLS);
+  const double r0 = rand() % ROWS, c0 = rand() % COLS;
+  for (int c = 0; c < COLS; c++)
+    for (int r = 0; r < ROWS; r++) {
+      const double d2 = (r - r0) * (r - r0) + (c - c0) * (c - c0);
+      A[c * ROWS + r] = exp(-d2 / 40.0) + 0.3 * sin(0.4 * r + 0.2 * c) *
+                        sin(0.3 * c) + 0.1 * rand() / (double)RAND_MAX + 0.4;
+    }
+  return A;
+}
+
+// the activation and normalization steps of gbvs.m
+static vector<double> saliency(const vector<double>& A,
+                               const GBVSFrameView& aframe,
+                               const GBVSFrameView& nframe, double tol,
+                               bool accel, GBVSPrecision precision) {
+  vector<double> act(A.size()), sal(A.size());
+  graphsalapply(&A[0], aframe, 0.15, 1, 2, tol, &act[0], accel, precision);
+  graphsalapply(&act[0], nframe, 0.06, 2, 1, tol, &sal[0], accel, precision);
+  return sal;
+}
+
+// the location map lx of makeLocationMap.m, rebuilt from the location index
+static vector<double> locationMap(const vector<int>& lxi) {
+  const int N = lxi[0], P = lxi[1];
+  const int *Lp = &lxi[2], *Lk = Lp + N + 1, *Li = Lk + P;
+  const int maxK = *max_element(Lk, Lk + P);
+  vector<double> lx((size_t)P * (2 + maxK), 0.0);
+  vector<int> filled(P, 0);
+  for (int i = 0; i < P; i++) {
+    lx[i] = i + 1;
+    lx[P + i] = Lk[i];
+  }
+  for (int l = 0; l < N; l++)
+    for (int j = Lp[l]; j < Lp[l + 1]; j++) {
+      const int i = Li[j];
+      lx[2 * P + (size_t)filled[i]++ * P + i] = l;
+    }
+  return lx;
+}
+
+int main() {
+  vector<int> multilevels(1, 2);
+  GBVSFrame frame;
+  graphsalinit(ROWS, COLS, multilevels, 2, 2, 2, frame);
+  const GBVSFrameView view = frameView(frame);
+  const int N = ROWS * COLS, P = frame.P;
+  const vector<double> A = testMap(1);
+  const vector<double> ref = saliency(A, view, view, 1e-4, false, GBVS_DOUBLE);
+
+  // sparse frames: with every edge the maps are the dense ones; cut at a
+  // weight of 1e-10 (one frame per sigma, as in main.cc) they differ by
+  // about the weights that were cut
+  {
+    GBVSFrame all;
+    graphsalinitSparse(ROWS, COLS, multilevels, 2, 2, 2, 1e30, all);
+    report("sparse frame with all edges against dense",
+           difference(ref, saliency(A, frameView(all), frameView(all), 1e-4,
+                                    false, GBVS_DOUBLE)),
+           1e-9);
+    GBVSFrame act, norm;
+    graphsalinitSparse(ROWS, COLS, multilevels, 2, 2, 2,
+                       graphsalMaxDistance(ROWS, COLS, 0.15, 1e-10), act);
+    graphsalinitSparse(ROWS, COLS, multilevels, 2, 2, 2,
+                       graphsalMaxDistance(ROWS, COLS, 0.06, 1e-10), norm);
+    report("sparse frames cut at weight 1e-10 against dense",
+           difference(ref, saliency(A, frameView(act), frameView(norm), 1e-4,
+                                    false, GBVS_DOUBLE)),
+           1e-6);
+  }
+
+  // single precision markov matrices: the equilibria to about the float
+  // precision (the tolerance is tightened so that it does not dominate)
+  report("single against double precision",
+         difference(saliency(A, view, view, 1e-8, false, GBVS_DOUBLE),
+                    saliency(A, view, view, 1e-8, false, GBVS_SINGLE)),
+         1e-5);
+
+  // extrapolated power iteration converges to the same equilibria
+  report("extrapolated against plain power iteration",
+         difference(saliency(A, view, view, 1e-10, false, GBVS_DOUBLE),
+                    saliency(A, view, view, 1e-10, true, GBVS_DOUBLE)),
+         1e-5);
+
+  // the batch runs the same kernels on each map (single-threaded, so the
+  // sums may be rounded differently than in the parallel kernels of a map)
+  {
+    const int M = 3;
+    vector<double> As, single;
+    for (int m = 0; m < M; m++) {
+      vector<double> Am = testMap(m + 2), Anorm(N);
+      As.insert(As.end(), Am.begin(), Am.end());
+      graphsalapply(&Am[0], view, 0.06, 2, 1, 1e-4, &Anorm[0], true);
+      single.insert(single.end(), Anorm.begin(), Anorm.end());
+    }
+    vector<double> batch(M * N);
+    graphsalapplyBatch(&As[0], M, view, 0.06, 2, 1, 1e-4, &batch[0], true);
+    report("batch against single maps", difference(single, batch), 1e-9);
+  }
+
+  // a frame mapped from its cache file is the frame that was saved
+  {
+    const string path = "gbvs_test.gbvsframe";
+    MappedFrame mapped;
+    const bool opened = saveFrame(path, frame) && mapped.open(path);
+    report("cache round trip: save and map", opened);
+    if (opened) {
+      const GBVSFrameView& mv = mapped.view();
+      const bool same =
+          mv.rows == ROWS && mv.cols == COLS && mv.P == P && mv.D &&
+          mv.numMultilevels == (int)multilevels.size() &&
+          equal(multilevels.begin(), multilevels.end(), mv.multilevels) &&
+          equal(frame.dims.begin(), frame.dims.end(), mv.dims) &&
+          equal(frame.D.begin(), frame.D.end(), mv.D) &&
+          equal(frame.lxi.begin(), frame.lxi.end(), mv.lxi);
+      report("cache round trip: arrays", same);
+      report("cache round trip: saliency",
+             difference(ref, saliency(A, mv, mv, 1e-4, false, GBVS_DOUBLE)),
+             0);
+      mapped.close();
+    }
+    remove(path.c_str());
+  }
+
+  // gatherOverScales adds the node values of each location in the order of
+  // sumOverScales, so the sums are identical, and the lx of makeLocationMap.m
+  // gives the same lxi
+  {
+    const vector<double> lx = locationMap(frame.lxi);
+    vector<int> lxi(locationIndexSize(&lx[0], P, N));
+    locationIndex(&lx[0], P, N, &lxi[0]);
+    report("location index of lx", lxi == frame.lxi);
+    vector<double> v(P), scatter(N), gather(N);
+    srand(7);
+    for (int i = 0; i < P; i++)
+      v[i] = rand() / (double)RAND_MAX;
+    sumOverScales(&v[0], &lx[0], P, N, &scatter[0]);
+    gatherOverScales(&v[0], &frame.lxi[0], &gather[0]);
+    report("gather against scatter over scales", difference(scatter, gather),
+           0);
+  }
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,175 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+#include "opencv2/opencv.hpp"
+#include "gbvs.h"
+#include "gbvsCache.h"
+
+using namespace cv;
+using namespace std;
+
+// defaults of makeGBVSParams.m
+#define SALMAP_MAX_SIZE 32
+#define SIGMA_FRAC_ACT 0.15
+#define SIGMA_FRAC_NORM 0.06
+#define NUM_NORM_ITERS 1
+#define TOL 0.0001
+#define CYCLIC_TYPE 2
+
+void help() {
+  cout << "Usage: \n"
+       << "gbvs_map <input_path> <output_path> [salmapmaxsize] "
+          "[sigma_frac_act] [sigma_frac_norm] [num_norm_iters] [tol] "
+          "[multilevels] [weight_tol] [eig_accel] [frame_cache_dir] "
+          "[precision]\n"
+       << "  Treats the grey-level input image as one feature map: makes a "
+          "graph-based activation map (algtype 2) and normalizes it "
+          "(algtype 1), as gbvs.m does for each feature map.\n"
+       << "  multilevels: comma separated list, e.g. 2,3 (default: none)\n"
+       << "  weight_tol: if > 0, use sparse graphs without the edges whose "
+          "weight is below weight_tol (default: 0, dense graph)\n"
+       << "  eig_accel: 1 => extrapolated power iteration, same map to within "
+          "tol in fewer iterations (default: 0)\n"
+       << "  frame_cache_dir: if given, the graph frames are mapped from "
+          "(or first saved to) this directory, see gbvsCache.h\n"
+       << "  precision: double, float (markov matrices in single precision, "
+          "half the memory) or validate (runs both, reports the largest "
+          "difference of the saliency maps, writes the double one) "
+          "(default: double)\n";
+}
+
+// OpenCV is row-major, the GBVS kernels are column-major
+static vector<double> toColumnMajor(const Mat& m) {
+  Mat t;
+  transpose(m, t);
+  return vector<double>(t.begin<double>(), t.end<double>());
+}
+
+static Mat fromColumnMajor(const vector<double>& v, int rows, int cols) {
+  Mat t(cols, rows, CV_64FC1, (void*)&v[0]), m;
+  transpose(t, m);
+  return m;
+}
+
+// the activation and normalization steps of gbvs.m on A; sal is scaled to
+// [0,1]. Returns the # of power iterations
+static int saliency(const vector<double>& A, const GBVSFrameView& aframe,
+                    const GBVSFrameView& nframe, double sigmaAct,
+                    double sigmaNorm, int normIters, double tol, bool accel,
+                    GBVSPrecision precision, vector<double>& sal) {
+  vector<double> act(A.size());
+  sal.resize(A.size());
+  int iters = graphsalapply(&A[0], aframe, sigmaAct, 1, 2, tol, &act[0],
+                            accel, precision);
+  iters += graphsalapply(&act[0], nframe, sigmaNorm, normIters, 1, tol,
+                         &sal[0], accel, precision);
+  mat2gray(&sal[0], (int)sal.size());
+  return iters;
+}
+
+int main(int args, char** argv) {
+  if (args < 3) {
+    cout << "wrong number of input arguments." << endl;
+    help();
+    return 1;
+  }
+
+  string INPUT_PATH = argv[1];
+  string OUTPUT_PATH = argv[2];
+  int SALMAPMAXSIZE = args > 3 ? atoi(argv[3]) : SALMAP_MAX_SIZE;
+  double SIGMA_ACT = args > 4 ? atof(argv[4]) : SIGMA_FRAC_ACT;
+  double SIGMA_NORM = args > 5 ? atof(argv[5]) : SIGMA_FRAC_NORM;
+  int NORM_ITERS = args > 6 ? atoi(argv[6]) : NUM_NORM_ITERS;
+  double TOLERANCE = args > 7 ? atof(argv[7]) : TOL;
+  vector<int> MULTILEVELS;
+  if (args > 8) {
+    stringstream ss(argv[8]);
+    string tok;
+    while (getline(ss, tok, ','))
+      if (!tok.empty()) MULTILEVELS.push_back(atoi(tok.c_str()));
+  }
+  double WEIGHT_TOL = args > 9 ? atof(argv[9]) : 0;
+  bool EIG_ACCEL = args > 10 ? atoi(argv[10]) != 0 : false;
+  string FRAME_CACHE_DIR = args > 11 ? argv[11] : "";
+  string PRECISION = args > 12 ? argv[12] : "double";
+  if (PRECISION != "double" && PRECISION != "float" &&
+      PRECISION != "validate") {
+    cout << "unknown precision " << PRECISION << endl;
+    help();
+    return 1;
+  }
+
+  Mat src = imread(INPUT_PATH, IMREAD_GRAYSCALE);
+  if (src.empty()) {
+    cerr << "could not read " << INPUT_PATH << endl;
+    return 1;
+  }
+
+  // salmapsize as in initGBVS.m
+  double scale = (double)SALMAPMAXSIZE / max(src.cols, src.rows);
+  int rows = (int)round(src.rows * scale), cols = (int)round(src.cols * scale);
+  Mat fmap;
+  src.convertTo(fmap, CV_64FC1, 1.0 / 255);
+  resize(fmap, fmap, Size(cols, rows), 0.0, 0.0, INTER_CUBIC);
+
+  // a sparse graph is cut according to its sigma, so each step gets its own
+  double actDist = 0, normDist = 0;
+  if (WEIGHT_TOL > 0) {
+    actDist = graphsalMaxDistance(rows, cols, SIGMA_ACT, WEIGHT_TOL);
+    normDist = graphsalMaxDistance(rows, cols, SIGMA_NORM, WEIGHT_TOL);
+  }
+  GBVSFrame frame, normFrame;
+  MappedFrame mappedFrame, mappedNormFrame;
+  GBVSFrameView aframe, nframe;
+  if (!FRAME_CACHE_DIR.empty()) {
+    if (!loadOrInitFrame(FRAME_CACHE_DIR, rows, cols, MULTILEVELS, 2, 2,
+                         CYCLIC_TYPE, actDist, mappedFrame) ||
+        (WEIGHT_TOL > 0 &&
+         !loadOrInitFrame(FRAME_CACHE_DIR, rows, cols, MULTILEVELS, 2, 2,
+                          CYCLIC_TYPE, normDist, mappedNormFrame))) {
+      cerr << "could not use the frame cache in " << FRAME_CACHE_DIR << endl;
+      return 1;
+    }
+    aframe = mappedFrame.view();
+    nframe = WEIGHT_TOL > 0 ? mappedNormFrame.view() : aframe;
+  } else {
+    if (WEIGHT_TOL > 0) {
+      graphsalinitSparse(rows, cols, MULTILEVELS, 2, 2, CYCLIC_TYPE, actDist,
+                         frame);
+      graphsalinitSparse(rows, cols, MULTILEVELS, 2, 2, CYCLIC_TYPE, normDist,
+                         normFrame);
+    } else {
+      graphsalinit(rows, cols, MULTILEVELS, 2, 2, CYCLIC_TYPE, frame);
+    }
+    aframe = frameView(frame);
+    nframe = frameView(WEIGHT_TOL > 0 ? normFrame : frame);
+  }
+
+  vector<double> A = toColumnMajor(fmap), norm;
+  int iters = saliency(A, aframe, nframe, SIGMA_ACT, SIGMA_NORM, NORM_ITERS,
+                       TOLERANCE, EIG_ACCEL,
+                       PRECISION == "float" ? GBVS_SINGLE : GBVS_DOUBLE, norm);
+  cout << "power iterations: " << iters << endl;
+  if (PRECISION == "validate") {
+    vector<double> single;
+    int singleIters = saliency(A, aframe, nframe, SIGMA_ACT, SIGMA_NORM,
+                               NORM_ITERS, TOLERANCE, EIG_ACCEL, GBVS_SINGLE,
+                               single);
+    double dev = 0;
+    for (size_t i = 0; i < norm.size(); i++)
+      dev = max(dev, fabs(norm[i] - single[i]));
+    cout << "power iterations (float): " << singleIters << endl
+         << "max deviation of the float saliency map: " << dev << endl;
+  }
+
+  Mat result;
+  fromColumnMajor(norm, rows, cols).convertTo(result, CV_8UC1, 255.0);
+  resize(result, result, src.size(), 0.0, 0.0, INTER_CUBIC);
+  imwrite(OUTPUT_PATH, result);
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+
+#include "mapPyramid.h"
+#include "mySubsample.h"
+
+MapPyramid::MapPyramid(int rows, int cols,
+                       const std::vector<int>& multilevels) {
+  layout(rows, cols, multilevels.empty() ? 0 : &multilevels[0],
+         (int)multilevels.size());
+}
+
+MapPyramid::MapPyramid(const GBVSFrameView& frame) {
+  layout(frame.rows, frame.cols, frame.multilevels, frame.numMultilevels);
+}
+
+void MapPyramid::layout(int rows, int cols, const int* multilevels,
+                        int numMultilevels) {
+  const int K = 1 + numMultilevels;
+  mDeltas.assign(1, 0);
+  mDeltas.insert(mDeltas.end(), multilevels, multilevels + numMultilevels);
+  int max_delta = *std::max_element(mDeltas.begin(), mDeltas.end());
+  std::vector<int> hs(max_delta + 1), ws(max_delta + 1);
+  hs[0] = rows; ws[0] = cols;
+  for (int i = 1; i <= max_delta; i++)
+    subsampledSize(hs[i-1], ws[i-1], hs[i], ws[i]);
+
+  mRows.resize(K); mCols.resize(K); mOffsets.resize(K);
+  int P = 0;
+  for (int i = 0; i < K; i++) {
+    mRows[i] = hs[mDeltas[i]];
+    mCols[i] = ws[mDeltas[i]];
+    mOffsets[i] = P;
+    P += mRows[i] * mCols[i];
+  }
+  mData.assign(P, 0);
+}
+
+void MapPyramid::build(const double* A) {
+  const int K = numLevels(), N = mRows[0] * mCols[0];
+  std::copy(A, A + N, level(0));
+  int max_delta = *std::max_element(mDeltas.begin(), mDeltas.end());
+  if (max_delta == 0)
+    return;
+
+  std::vector<float> last(A, A + N), next(N), col(mRows[0]);
+  int h = mRows[0], w = mCols[0];
+  for (int d = 1; d <= max_delta; d++) {
+    int hr, wr;
+    mySubsample(&last[0], &next[0], &col[0], h, w, hr, wr);
+    last.swap(next);
+    h = hr; w = wr;
+    for (int i = 1; i < K; i++)
+      if (mDeltas[i] == d)
+        std::copy(last.begin(), last.begin() + h * w, level(i));
+  }
+}
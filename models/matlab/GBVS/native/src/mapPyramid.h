@@ -0,0 +1,52 @@
+#ifndef GBVS_MAP_PYRAMID_H
+#define GBVS_MAP_PYRAMID_H
+
+#include <vector>
+
+#include "gbvs.h"
+
+// size of a map after one mySubsample
+inline void subsampledSize(int h, int w, int& hr, int& wr) {
+  hr = h; wr = w;
+  if ((w > 10) && (h > 10)) {
+    hr = h / 2;
+    wr = w / 2;
+  }
+}
+
+// The scales of a map as the nodes of a GBVS graph see them: the map itself,
+// then one subsampled level per entry of multilevels. All the levels share one
+// buffer, each column-major and right after the previous one, which is the
+// linear node order of mexArrangeLinear: data() is the P x 1 vector the
+// markov kernels work on, and level(i) a view of one scale of it. Building,
+// linearizing and reshaping maps needs no padded N x M x K block and no
+// copies between layouts.
+class MapPyramid {
+ public:
+  MapPyramid(int rows, int cols, const std::vector<int>& multilevels);
+  // the levels of the nodes of frame
+  explicit MapPyramid(const GBVSFrameView& frame);
+
+  // formMapPyramid.m without the padding: level 0 is A (rows x cols) and the
+  // others are subsampled from it in single precision, as mySubsample does
+  void build(const double* A);
+
+  int numLevels() const { return (int)mRows.size(); }
+  int rows(int i) const { return mRows[i]; }
+  int cols(int i) const { return mCols[i]; }
+  int size() const { return (int)mData.size(); }
+
+  double* level(int i) { return &mData[mOffsets[i]]; }
+  const double* level(int i) const { return &mData[mOffsets[i]]; }
+  double* data() { return &mData[0]; }
+  const double* data() const { return &mData[0]; }
+
+ private:
+  void layout(int rows, int cols, const int* multilevels, int numMultilevels);
+
+  std::vector<int> mDeltas;    // binary orders below the map of each level
+  std::vector<int> mRows, mCols, mOffsets;
+  std::vector<double> mData;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef LOCAL_MAXIMA_H
+#define LOCAL_MAXIMA_H
+
+#include <stddef.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// Local maxima statistics behind mexLocalMaximaGBVS (maxNormalizeStdGBVS).
+// Maps are column-major doubles, h rows by w columns.
+
+// ######################################################################
+// lm_num = # of interior points that are >= thresh and >= their 4 neighbours,
+// lm_sum = sum of their values. The loop runs down contiguous columns and
+// combines the tests into a mask instead of branches; with SSE2 (every x86-64
+// compiler) two rows are tested at a time. Compilers do not vectorize the
+// scalar loop by themselves: its floating point compares may trap, so they
+// are not if-converted. The sum is taken column by column and lane by lane
+// rather than row by row, which may change its last bits; lm_num is exact.
+
+inline void localMaximaColumn(const double* l, const double* c, const double* r,
+                              double thresh, int h, double& sum, int& num)
+{
+  int j = 1;
+  double csum = 0.0;
+  int cnum = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+  const __m128d vt = _mm_set1_pd(thresh), one = _mm_set1_pd(1.0);
+  __m128d vs = _mm_setzero_pd(), vn = _mm_setzero_pd();
+  for (; j + 1 < h - 1; j += 2)
+    {
+      const __m128d val = _mm_loadu_pd(c + j);
+      __m128d m = _mm_cmpge_pd(val, vt);
+      m = _mm_and_pd(m, _mm_cmpge_pd(val, _mm_loadu_pd(l + j)));
+      m = _mm_and_pd(m, _mm_cmpge_pd(val, _mm_loadu_pd(r + j)));
+      m = _mm_and_pd(m, _mm_cmpge_pd(val, _mm_loadu_pd(c + j - 1)));
+      m = _mm_and_pd(m, _mm_cmpge_pd(val, _mm_loadu_pd(c + j + 1)));
+      vs = _mm_add_pd(vs, _mm_and_pd(m, val));
+      vn = _mm_add_pd(vn, _mm_and_pd(m, one));
+    }
+  double ls[2], ln[2];
+  _mm_storeu_pd(ls, vs);
+  _mm_storeu_pd(ln, vn);
+  csum = ls[0] + ls[1];
+  cnum = (int)(ln[0] + ln[1]);
+#endif
+  for (; j < h - 1; j++)
+    {
+      const double val = c[j];
+      const int is_max = (val >= thresh) & (val >= l[j]) & (val >= r[j]) &
+                         (val >= c[j - 1]) & (val >= c[j + 1]);
+      csum += is_max ? val : 0.0;
+      cnum += is_max;
+    }
+  sum += csum;
+  num += cnum;
+}
+
+inline void getLocalMaxima(const double* img, double thresh, int* lm_num,
+                           double* lm_sum, int w, int h)
+{
+  int i;
+  double sum = 0.0;
+  int num = 0;
+  for (i = 1; i < w - 1; i++)
+    {
+      const double* c = img + (size_t)i * h;
+      localMaximaColumn(c - h, c, c + h, thresh, h, sum, num);
+    }
+  *lm_sum = sum;
+  *lm_num = num;
+}
+
+// ######################################################################
+// statistics of the K maps of an h x w x K stack, in parallel over the maps:
+// lm_avg[k] = lm_sum[k] / lm_num[k] (0 without local maxima above thresh)
+
+inline void getLocalMaximaStack(const double* maps, double thresh, int K,
+                                double* lm_avg, double* lm_num, double* lm_sum,
+                                int w, int h)
+{
+  int k;
+#pragma omp parallel for schedule(dynamic)
+  for (k = 0; k < K; k++)
+    {
+      int num;
+      double sum;
+      getLocalMaxima(maps + (size_t)k * h * w, thresh, &num, &sum, w, h);
+      lm_avg[k] = (sum > 0) ? sum / (double)num : 0.0;
+      lm_num[k] = num;
+      lm_sum[k] = sum;
+    }
+}
+
+#endif
@@ -23,17 +23,50 @@ function result = maxNormalizeStdGBVS(data)
 %
 % modified by jonathan harel 2008 for GBVS code
 %  .. simplified
+%
+% data may also be an h x w x K stack of maps: each map is normalized on its
+% own, and the local maxima of all of them are found in one mex call (or in
+% one call per map with a mexLocalMaximaGBVS that predates stacks, e.g. the
+% pre-compiled binaries, see localMaximaTakeStacks)
   
 M = 10;
 
-data = mat2gray( data ) * M;
+K = size(data,3);
+if ( K == 1 )
+  data = mat2gray( data ) * M;
+else
+  maps = zeros(size(data));
+  for k = 1 : K
+    maps(:,:,k) = mat2gray( data(:,:,k) ) * M;
+  end
+  data = maps;
+end
 thresh = M / 10;
-[lm_avg,lm_num,lm_sum] = mexLocalMaximaGBVS(data,thresh);
-
-if (lm_num > 1)
-  result = data * (M - lm_avg)^2;
-elseif (lm_num == 1)
-  result = data * M .^ 2;
+if ( K == 1 || localMaximaTakeStacks )
+  [lm_avg,lm_num,lm_sum] = mexLocalMaximaGBVS(data,thresh);
 else
-  result = data;
+  lm_avg = zeros(1,K); lm_num = zeros(1,K); lm_sum = zeros(1,K);
+  for k = 1 : K
+    [lm_avg(k),lm_num(k),lm_sum(k)] = mexLocalMaximaGBVS(data(:,:,k),thresh);
+  end
+end
+
+result = data;
+for k = 1 : K
+  if (lm_num(k) > 1)
+    result(:,:,k) = data(:,:,k) * (M - lm_avg(k))^2;
+  elseif (lm_num(k) == 1)
+    result(:,:,k) = data(:,:,k) * M .^ 2;
+  end
+end
+
+function takes = localMaximaTakeStacks
+% true if mexLocalMaximaGBVS returns one result per map of an h x w x K
+% stack. Older builds treat the stack as one h x (w*K) map and return
+% scalars (no out-of-bounds access), so a 3 x 3 x 2 probe tells them apart.
+persistent stack_capable;
+if ( isempty(stack_capable) )
+  [lm_avg,lm_num] = mexLocalMaximaGBVS(zeros(3,3,2),1);
+  stack_capable = ( numel(lm_num) == 2 );
 end
+takes = stack_capable;
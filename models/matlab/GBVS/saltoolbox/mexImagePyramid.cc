@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mex.h>
+#include <math.h>
+#include <matrix.h>
+#include <string.h>
+#include <vector>
+
+#include "mySubsample.h"
+
+//  pyr = mexImagePyramid( imgs , nlevels )
+//
+//  name      dim         description
+// -------------------------------------------------------------------------
+//  imgs      h x w x C   images to subsample, e.g. cat(3,L,R,G,B)
+//  nlevels   1 x 1       # of levels
+//  pyr       nlevels x C cell: pyr{i,c} is image c after i mySubsample calls
+//
+//  Same results as the calls to mySubsample in getFeatureMaps.m, in one call:
+//  each level is subsampled straight from the previous one's double array,
+//  and the channels of a level are computed in parallel with OpenMP.
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+  // Declarations
+  const mwSize *dims;
+  int h, w, C, nlevels, i, c, hr, wr;
+  mxArray *out;
+
+  dims = mxGetDimensions(prhs[0]);
+  h = dims[0];
+  w = dims[1];
+  C = mxGetNumberOfDimensions(prhs[0]) > 2 ? dims[2] : 1;
+  nlevels = (int)mxGetScalar(prhs[1]);
+
+  out = mxCreateCellMatrix(nlevels, C);
+  plhs[0] = out;
+
+  // images of the previous and current level of each channel
+  std::vector<const double*> src(C);
+  std::vector<double*> dst(C);
+  for (c=0;c<C;c++)
+    src[c] = mxGetPr(prhs[0]) + (size_t)c * h * w;
+
+  for (i=0;i<nlevels;i++) {
+    // the MATLAB API is not thread safe: arrays are made before the
+    // parallel loop
+    hr = h; wr = w;
+    if ( (w > 10) && (h > 10) ) {
+      hr = h / 2;
+      wr = w / 2;
+    }
+    for (c=0;c<C;c++) {
+      mxArray *level = mxCreateDoubleMatrix(hr, wr, mxREAL);
+      mxSetCell(out, i + c * nlevels, level);
+      dst[c] = mxGetPr(level);
+    }
+
+#pragma omp parallel for schedule(static)
+    for (c=0;c<C;c++) {
+      std::vector<float> col(h + 1);
+      int hi, wi;
+      mySubsample( src[c] , dst[c] , &col[0] , h , w , hi , wi );
+    }
+
+    for (c=0;c<C;c++)
+      src[c] = dst[c];
+    h = hr; w = wr;
+  }
+
+  return;
+}
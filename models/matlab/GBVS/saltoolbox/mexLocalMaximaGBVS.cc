@@ -5,64 +5,38 @@
 #include <matrix.h>
 #include <string.h>
 
-double getVal(double* img, int x, int y, int w, int h);
-void getLocalMaxima(double* img, double thresh, int *lm_num, double *lm_sum, int w, int h);
+#include "localMaxima.h"
+
+//  [lm_avg,lm_num,lm_sum] = mexLocalMaximaGBVS( maps , thresh )
+//
+//  name      dim      description
+// -------------------------------------------
+//  maps      hxwxK    one map, or K maps of the same size stacked
+//  thresh    1x1      local maxima below thresh are not counted
+//  lm_avg    1xK      mean value of the local maxima of each map
+//  lm_num    1xK      # of local maxima of each map
+//  lm_sum    1xK      sum of the local maxima of each map
+//
+//  A stack is processed in one call, with OpenMP across its maps.
 
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-{  
-  // input
-  double* img, *thresh;
-  
-  // output
-  double lm_avg, lm_sum; int lm_num;
-
-  double* tmp;
-  
-  img = mxGetPr( prhs[0] );
-  thresh = mxGetPr( prhs[1] );
-
-  getLocalMaxima( img, thresh[0] , &lm_num, &lm_sum , mxGetN(prhs[0]) , mxGetM(prhs[0]) );
-  
-  if (lm_sum > 0) lm_avg = (double)lm_sum / (double)lm_num;
-  else lm_avg = 0.0;
-  
-  plhs[0] = mxCreateDoubleMatrix(1, 1, mxREAL); //mxReal is our data-type
-  plhs[1] = mxCreateDoubleMatrix(1, 1, mxREAL); //mxReal is our data-type
-  plhs[2] = mxCreateDoubleMatrix(1, 1, mxREAL); //mxReal is our data-type
-  
-  tmp = mxGetPr(plhs[0]); tmp[0] = lm_avg;
-  tmp = mxGetPr(plhs[1]); tmp[0] = lm_num;
-  tmp = mxGetPr(plhs[2]); tmp[0] = lm_sum;
-}
-
-double getVal(double* img, int x, int y, int w, int h) 
 {
-  double* ptr = img + x * h + y;  
-  return *ptr;
-}
-
-void getLocalMaxima(double* img, double thresh, int *lm_num, double *lm_sum, int w, int h)
-{
-  int i,j;
-  double val;
-  // then get the mean value of the local maxima:
-  *lm_sum = 0.0; *lm_num = 0;
-  
-  for (j = 1; j < h - 1; j ++)
-    for (i = 1; i < w - 1; i ++)
-      {
-        val = getVal(img,i,j,w,h);
-        if (val >= thresh &&
-            val >= getVal(img,i-1, j,w,h) &&
-            val >= getVal(img,i+1, j,w,h) &&
-            val >= getVal(img,i, j+1,w,h) &&
-            val >= getVal(img,i, j-1,w,h))  // local max
-          {
-            *lm_sum += val;
-            (*lm_num)++;
-          }
-      }
-  return;
+  // input
+  const mwSize *dims;
+  double* maps, thresh;
+  int w, h, K;
+
+  dims = mxGetDimensions( prhs[0] );
+  h = dims[0];
+  w = dims[1];
+  K = mxGetNumberOfDimensions( prhs[0] ) > 2 ? dims[2] : 1;
+  maps = mxGetPr( prhs[0] );
+  thresh = mxGetScalar( prhs[1] );
+
+  plhs[0] = mxCreateDoubleMatrix(1, K, mxREAL); //mxReal is our data-type
+  plhs[1] = mxCreateDoubleMatrix(1, K, mxREAL); //mxReal is our data-type
+  plhs[2] = mxCreateDoubleMatrix(1, K, mxREAL); //mxReal is our data-type
+
+  getLocalMaximaStack( maps , thresh , K , mxGetPr(plhs[0]) , mxGetPr(plhs[1]) ,
+                       mxGetPr(plhs[2]) , w , h );
 }
-
-
@@ -0,0 +1,121 @@
+#ifndef MY_SUBSAMPLE_H
+#define MY_SUBSAMPLE_H
+
+// Decimation kernels behind mySubsample, shared with the native (MATLAB-free)
+// library in ../native. Images are column-major, h rows by w columns.
+
+// ######################################################################
+// kernel: 1 5 10 10 5 1, along x (lowPass6xDecX) then along y
+// (lowPass6yDecY), fused: each column of the x-decimated image is decimated
+// along y as soon as it is made, so the intermediate image is a single column
+// (col: h floats) instead of h x w/2. The arithmetic is that of the two
+// passes (float samples, double weights, float results), and so are the
+// results, whatever the source and result types: a double source is read as
+// floats and a double result holds the float values, which saves the float
+// copies of double images. The x loops run down contiguous columns, which the
+// compiler vectorizes. Needs h, w >= 4.
+
+template <class TI>
+inline void lowPass6xDecXColumn(const TI* src, float* col, int ws, int h, int xr)
+{
+  int y;
+  const TI* s0;
+  if (xr == 0)
+    {
+      // left most point - use kernel [10 10 5 1] / 26
+      for (y = 0; y < h; ++y)
+        col[y] = (((float)src[y] + (float)src[y + h]) * 10.0 +
+                  (float)src[y + 2 * h] * 5.0 + (float)src[y + 3 * h]) / 26.0;
+      return;
+    }
+  const int x = 2 * (xr - 1);
+  s0 = src + (size_t)x * h;
+  const TI *s1 = s0 + h, *s2 = s1 + h, *s3 = s2 + h;
+  if (x < ws - 5)
+    {
+      // use kernel [1 5 10 10 5 1] / 32
+      const TI *s4 = s3 + h, *s5 = s4 + h;
+      for (y = 0; y < h; ++y)
+        col[y] = (((float)s1[y] + (float)s4[y]) *  5.0 +
+                  ((float)s2[y] + (float)s3[y]) * 10.0 +
+                  ((float)s0[y] + (float)s5[y])) / 32.0;
+    }
+  else if (x == ws - 5)
+    {
+      // use kernel [1 5 10 10 5] / 31
+      const TI *s4 = s3 + h;
+      for (y = 0; y < h; ++y)
+        col[y] = (((float)s1[y] + (float)s4[y]) *  5.0 +
+                  ((float)s2[y] + (float)s3[y]) * 10.0 +
+                  (float)s0[y]) / 31.0;
+    }
+  else
+    {
+      // use kernel [1 5 10 10] / 26
+      for (y = 0; y < h; ++y)
+        col[y] = ((float)s0[y] + (float)s1[y] *  5.0 +
+                  ((float)s2[y] + (float)s3[y]) * 10.0) / 26.0;
+    }
+}
+
+// lowPass6yDecY of one column of hs >= 4 samples
+template <class TO>
+inline void lowPass6yDecYColumn(const float* sptr, TO* rptr, int hs)
+{
+  int y, n = (hs - 4) / 2;  // # of points with the general kernel
+  // top most point - use kernel [10 10 5 1]^T / 26
+  rptr[0] = (float)(((sptr[0] + sptr[1]) * 10.0 + sptr[2] * 5.0 + sptr[3]) / 26.0);
+
+  // general case (indexed rather than pointer-walking, so it vectorizes)
+  for (y = 0; y < n; ++y)
+    {
+      // use kernel [1 5 10 10 5 1]^T / 32
+      const float* p = sptr + 2 * y;
+      rptr[y + 1] = (float)(((p[1] + p[4])  *  5.0 +
+                             (p[2] + p[3])  * 10.0 +
+                             (p[0] + p[5])) / 32.0);
+    }
+  sptr += 2 * n;
+
+  if (hs & 1)
+    // use kernel [1 5 10 10 5]^T / 31
+    rptr[n + 1] = (float)(((sptr[1] + sptr[4])  *  5.0 +
+                           (sptr[2] + sptr[3])  * 10.0 +
+                           sptr[0])            / 31.0);
+  else
+    // use kernel [1 5 10 10]^T / 26
+    rptr[n + 1] = (float)((sptr[0] + sptr[1]  *  5.0 +
+                           (sptr[2] + sptr[3]) * 10.0) / 26.0);
+}
+
+// src: h x w, dst: (h/2) x (w/2), col: h floats
+template <class TI, class TO>
+inline void lowPass6DecXY(const TI* src, TO* dst, float* col, int h, int w)
+{
+  const int wr = w / 2, hr = h / 2;
+  for (int xr = 0; xr < wr; ++xr)
+    {
+      lowPass6xDecXColumn( src , col , w , h , xr );
+      lowPass6yDecYColumn( col , dst + (size_t)xr * hr , h );
+    }
+}
+
+// ######################################################################
+// halves both dimensions of an h x w image (hr x wr result), or copies it
+// when it is too small to subsample; tmp must hold h floats
+template <class TI, class TO>
+inline void mySubsample(const TI* img, TO* out, float* tmp, int h, int w, int& hr, int& wr)
+{
+  int i;
+  if ( (w > 10) && (h > 10) ) {
+    wr = w / 2;
+    hr = h / 2;
+    lowPass6DecXY( img , out , tmp , h , w );
+  } else {
+    wr = w;
+    hr = h;
+    for (i=0;i<h*w;i++) out[i] = img[i];
+  }
+}
+
+#endif
@@ -19,24 +19,41 @@ imgr = []; imgg = []; imgb = [];
 if ( is_color ) [imgr,imgg,imgb,imgi] = mygetrgb( img );
 else imgi = img; end
 
+% all channels and levels in one call, if compiled (see saltoolbox/mexImagePyramid.cc)
+fastpyr = ( exist('mexImagePyramid') == 3 );
+
 imgL = {};
-imgL{1} = mySubsample(imgi);
-imgR{1} = mySubsample(imgr); imgG{1} = mySubsample(imgg); imgB{1} = mySubsample(imgb);
+if ( fastpyr )
+    nlevels = max( [ 1 levels ] );
+    if ( is_color )
+        pyr = mexImagePyramid( cat(3,imgi,imgr,imgg,imgb) , nlevels );
+        imgL = pyr(:,1)'; imgR = pyr(:,2)'; imgG = pyr(:,3)'; imgB = pyr(:,4)';
+    else
+        pyr = mexImagePyramid( imgi , nlevels );
+        imgL = pyr(:,1)'; imgR = cell(1,nlevels); imgG = imgR; imgB = imgR;
+    end
+else
+    imgL{1} = mySubsample(imgi);
+    imgR{1} = mySubsample(imgr); imgG{1} = mySubsample(imgg); imgB{1} = mySubsample(imgb);
+end
 
 for i=levels
 
-    imgL{i} = mySubsample( imgL{i-1} );
-    if ( is_color )
-        imgR{i} = mySubsample( imgR{i-1} );
-        imgG{i} = mySubsample( imgG{i-1} );
-        imgB{i} = mySubsample( imgB{i-1} );
-    else
-        imgR{i} = []; imgG{i} = []; imgB{i} = [];
+    if ( ~fastpyr )
+        imgL{i} = mySubsample( imgL{i-1} );
+        if ( is_color )
+            imgR{i} = mySubsample( imgR{i-1} );
+            imgG{i} = mySubsample( imgG{i-1} );
+            imgB{i} = mySubsample( imgB{i-1} );
+        else
+            imgR{i} = []; imgG{i} = []; imgB{i} = [];
+        end
     end
     if ( (size(imgL{i},1) < 3) | (size(imgL{i},2) < 3 ) )
         mymessage(param,'reached minimum size at level = %d. cutting off additional levels\n', i);
         levels = [ 2 : i ];
         param.maxcomputelevel = i;
+        imgL = imgL(1:i); imgR = imgR(1:i); imgG = imgG(1:i); imgB = imgB(1:i);
         break;
     end
 
@@ -0,0 +1,97 @@
+#ifndef MY_CONTRAST_H
+#define MY_CONTRAST_H
+
+#include <stddef.h>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Local variance behind myContrast, shared with the native (MATLAB-free)
+// library in ../native. Images are column-major doubles, h rows by w columns.
+
+// rows per band of the parallel loops: a band of every column of the tables
+// stays in cache while the columns are walked
+#define CONTRAST_BAND_ROWS 64
+
+// ######################################################################
+// out(j,i) = variance of img over the M x M window centred on (j,i), clipped
+// to the image (the window is 2*floor(M/2)+1 wide, even for an even M).
+//
+// Summed-area tables of x and x^2, (h+1) x (w+1) with a zero first row and
+// column, give the sum and sum of squares of any window from four entries, so
+// each pixel is O(1) whatever M. The image mean is subtracted before the
+// tables are made (the variance does not change): the sums then stay small
+// and sum(x^2) - n * mean^2 loses no more precision than the windowed sums
+// did. The column sums run in parallel over columns, the row sums and the
+// output in parallel over bands of rows.
+
+inline void localVariance(const double* img, double* out, int h, int w, int M)
+{
+  const int Mo2 = M / 2;
+  const int H = h + 1;
+  const int nb = (h + CONTRAST_BAND_ROWS - 1) / CONTRAST_BAND_ROWS;
+  std::vector<double> S((size_t)H * (w + 1)), SS((size_t)H * (w + 1));
+  int i, j, b;
+  double mu = 0;
+
+  for (i=0;i<h*w;i++) mu += img[i];
+  if ( h * w > 0 ) mu /= (double)h * w;
+
+  // cumulative sums down each column
+#pragma omp parallel for private(j) schedule(static)
+  for (i=0;i<w;i++) {
+    const double* x = img + (size_t)i * h;
+    double* s = &S[(size_t)(i + 1) * H];
+    double* ss = &SS[(size_t)(i + 1) * H];
+    double a = 0, aa = 0;
+    for (j=0;j<h;j++) {
+      double p = x[j] - mu;
+      a += p;
+      aa += p * p;
+      s[j + 1] = a;
+      ss[j + 1] = aa;
+    }
+  }
+
+  // cumulative sums along each row
+#pragma omp parallel for private(i,j) schedule(static)
+  for (b=0;b<nb;b++) {
+    const int j0 = 1 + b * CONTRAST_BAND_ROWS;
+    const int j1 = (j0 + CONTRAST_BAND_ROWS < H) ? j0 + CONTRAST_BAND_ROWS : H;
+    for (i=2;i<=w;i++) {
+      double* s = &S[(size_t)i * H];
+      double* ss = &SS[(size_t)i * H];
+      for (j=j0;j<j1;j++) {
+        s[j] += s[j - H];
+        ss[j] += ss[j - H];
+      }
+    }
+  }
+
+  // window sums from the corners of the tables
+#pragma omp parallel for private(i,j) schedule(static)
+  for (b=0;b<nb;b++) {
+    const int j0 = b * CONTRAST_BAND_ROWS;
+    const int j1 = (j0 + CONTRAST_BAND_ROWS < h) ? j0 + CONTRAST_BAND_ROWS : h;
+    for (i=0;i<w;i++) {
+      const int c0 = (i - Mo2 < 0) ? 0 : i - Mo2;
+      const int c1 = (i + Mo2 + 1 > w) ? w : i + Mo2 + 1;
+      const double *s0 = &S[(size_t)c0 * H], *s1 = &S[(size_t)c1 * H];
+      const double *ss0 = &SS[(size_t)c0 * H], *ss1 = &SS[(size_t)c1 * H];
+      double* o = out + (size_t)i * h;
+      for (j=j0;j<j1;j++) {
+        const int r0 = (j - Mo2 < 0) ? 0 : j - Mo2;
+        const int r1 = (j + Mo2 + 1 > h) ? h : j + Mo2 + 1;
+        const double ni = (double)(r1 - r0) * (c1 - c0);
+        const double sum = s1[r1] - s1[r0] - s0[r1] + s0[r0];
+        const double sumsq = ss1[r1] - ss1[r0] - ss0[r1] + ss0[r0];
+        const double mean = sum / ni;
+        const double var = (sumsq - ni * mean * mean) / ni;
+        o[j] = (var > 0) ? var : 0;
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,265 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+
+#include "dct_plan.hpp"
+#include "dct_simd.hpp"
+
+#ifdef QSS_DCT_BENCH_FFTW
+#include <fftw3.h>
+#endif
+
+using namespace std;
+
+// Microbenchmark of the hard-coded DCT codelets (dct_type2_48/64,
+// dct_type3_48/64): ns per transform, GFLOP/s and the largest relative error
+// against a long double reference, for float and double, three (v, stride)
+// layouts, and the baselines
+//   simd:    the vectorized codelets of dct_simd.hpp (W transforms at once)
+//   naive:   the O(n^2) sums with tabled cosines
+//   makhoul: the planned FFT-based DCT of dct_plan.hpp without the codelets
+//   fftw:    FFTW's REDFT10/REDFT01 (if CMake found FFTW)
+// GFLOP/s follow the convention of benchFFT for real-data transforms,
+// 2.5 n log2(n) flops per transform, i.e. they compare the time of the
+// methods, not the operations that they actually perform.
+
+void help() {
+  cout << "Usage: \n"
+       << "qss_dct_bench [min_time_ms]\n"
+       << "  min_time_ms: each measurement repeats the transforms for at "
+          "least this long, the best of 5 is reported (default: 20)\n";
+}
+
+// the layouts of the codelet interface (see dct_plan.hpp): v arrays of n
+// elements, elements is/os apart, arrays ivs/ovs apart
+struct Layout {
+  string name;
+  int v, is, ivs;  // os = is, ovs = ivs
+};
+
+// single: one transform; columns: the columns of an n x n matrix, as in the
+// column pass of the 2-D DCT; rows: its rows, as in the row pass (strided)
+static vector<Layout> layouts(int n) {
+  vector<Layout> l(3);
+  l[0].name = "single";  l[0].v = 1; l[0].is = 1; l[0].ivs = n;
+  l[1].name = "columns"; l[1].v = n; l[1].is = 1; l[1].ivs = n;
+  l[2].name = "rows";    l[2].v = n; l[2].is = n; l[2].ivs = 1;
+  return l;
+}
+
+// FFTW conventions (unnormalized), in long double
+static void referenceDct(const vector<long double>& in, vector<long double>& out,
+                         int n, int type) {
+  const long double pi = 3.141592653589793238462643383279502884L;
+  for (int k = 0; k < n; k++) {
+    long double s = 0;
+    if (type == 2) {
+      for (int j = 0; j < n; j++)
+        s += in[j] * cosl(pi * k * (2 * j + 1) / (2 * n));
+      out[k] = 2 * s;
+    } else {
+      for (int j = 1; j < n; j++)
+        s += in[j] * cosl(pi * j * (2 * k + 1) / (2 * n));
+      out[k] = in[0] + 2 * s;
+    }
+  }
+}
+
+template <typename T>
+class NaiveDct {
+public:
+  NaiveDct(int _n, int _type) : n(_n), type(_type), table(_n * _n) {
+    for (int k = 0; k < n; k++)
+      for (int j = 0; j < n; j++)
+        table[k * n + j] = (type == 2 ? T(2) : (j ? T(2) : T(1))) *
+            T(cos(DCT_PLAN_PI * (type == 2 ? k * (2 * j + 1) : j * (2 * k + 1)) /
+                  (2.0 * n)));
+  }
+  void operator()(const T* I, T* O, const Layout& l) const {
+    for (int a = 0; a < l.v; a++) {
+      const T* in = I + a * l.ivs;
+      T* out = O + a * l.ivs;
+      for (int k = 0; k < n; k++) {
+        T s = 0;
+        for (int j = 0; j < n; j++)
+          s += table[k * n + j] * in[j * l.is];
+        out[k * l.is] = s;
+      }
+    }
+  }
+
+private:
+  int n, type;
+  vector<T> table;
+};
+
+#ifdef QSS_DCT_BENCH_FFTW
+// fftw_plan / fftwf_plan for the (unnormalized) REDFT10 / REDFT01
+template <typename T> struct Fftw;
+template <> struct Fftw<double> {
+  fftw_plan plan;
+  Fftw(int n, int type, const Layout& l, double* I, double* O) {
+    fftw_r2r_kind kind = type == 2 ? FFTW_REDFT10 : FFTW_REDFT01;
+    plan = fftw_plan_many_r2r(1, &n, l.v, I, 0, l.is, l.ivs, O, 0, l.is,
+                              l.ivs, &kind, FFTW_MEASURE);
+  }
+  ~Fftw() { fftw_destroy_plan(plan); }
+  void operator()() const { fftw_execute(plan); }
+};
+template <> struct Fftw<float> {
+  fftwf_plan plan;
+  Fftw(int n, int type, const Layout& l, float* I, float* O) {
+    fftw_r2r_kind kind = type == 2 ? FFTW_REDFT10 : FFTW_REDFT01;
+    plan = fftwf_plan_many_r2r(1, &n, l.v, I, 0, l.is, l.ivs, O, 0, l.is,
+                               l.ivs, &kind, FFTW_MEASURE);
+  }
+  ~Fftw() { fftwf_destroy_plan(plan); }
+  void operator()() const { fftwf_execute(plan); }
+};
+#endif
+
+// ns per call of f: the best of 5 runs of at least min_time_ms each
+template <class F>
+static double timeCall(const F& f, double min_time_ms) {
+  typedef chrono::steady_clock clock;
+  double best = 1e300;
+  for (int run = 0; run < 5; run++) {
+    long calls = 0;
+    clock::time_point start = clock::now();
+    double elapsed = 0;
+    while (elapsed < min_time_ms * 1e6) {
+      for (int i = 0; i < 16; i++)
+        f();
+      calls += 16;
+      elapsed = chrono::duration<double, nano>(clock::now() - start).count();
+    }
+    best = min(best, elapsed / calls);
+  }
+  return best;
+}
+
+template <typename T>
+struct Bench {
+  int n, type;
+  Layout layout;
+  vector<T> I, O;
+  vector<long double> reference;  // of O, for the input I
+
+  Bench(int _n, int _type, const Layout& l)
+      : n(_n), type(_type), layout(l), I(n * n), O(n * n), reference(n * n) {
+    fill();
+  }
+
+  void fill() {
+    srand(1);
+    for (size_t i = 0; i < I.size(); i++)
+      I[i] = T(rand() / (double)RAND_MAX - 0.5);
+    vector<long double> in(n), out(n);
+    for (int a = 0; a < layout.v; a++) {
+      for (int j = 0; j < n; j++)
+        in[j] = I[a * layout.ivs + j * layout.is];
+      referenceDct(in, out, n, type);
+      for (int k = 0; k < n; k++)
+        reference[a * layout.ivs + k * layout.is] = out[k];
+    }
+  }
+
+  // the largest error of O relative to the largest reference value
+  double error() const {
+    long double err = 0, scale = 0;
+    for (int a = 0; a < layout.v; a++)
+      for (int k = 0; k < n; k++) {
+        const int i = a * layout.ivs + k * layout.is;
+        err = max(err, fabsl((long double)O[i] - reference[i]));
+        scale = max(scale, fabsl(reference[i]));
+      }
+    return (double)(err / scale);
+  }
+
+  void report(const string& method, double ns) const {
+    const double per_transform = ns / layout.v;
+    const double flops = 2.5 * n * log2((double)n);
+    cout << setw(3) << n << "  " << (type == 2 ? "II " : "III") << "  "
+         << setw(6) << (sizeof(T) == sizeof(float) ? "float" : "double")
+         << "  " << setw(7) << layout.name << "  " << setw(7) << method
+         << "  " << setw(10) << fixed << setprecision(1) << per_transform
+         << "  " << setw(7) << setprecision(2) << flops / per_transform
+         << "  " << scientific << setprecision(2) << error() << endl;
+    cout.unsetf(ios::floatfield);
+  }
+};
+
+template <typename T>
+static void run(int n, int type, const Layout& l, double min_time_ms) {
+  Bench<T> b(n, type, l);
+  const T* I = &b.I[0];
+  T* O = &b.O[0];
+
+  typedef void (*Codelet)(const T*, T*, int, int, int, int, int);
+  Codelet codelet, simd;
+  if (n == 48) {
+    codelet = type == 2 ? &dct_type2_48<T, int, int> : &dct_type3_48<T, int, int>;
+    simd = type == 2 ? &dct_type2_48_simd<T> : &dct_type3_48_simd<T>;
+  } else {
+    codelet = type == 2 ? &dct_type2_64<T, int, int> : &dct_type3_64<T, int, int>;
+    simd = type == 2 ? &dct_type2_64_simd<T> : &dct_type3_64_simd<T>;
+  }
+  const DctPlan<T> makhoul(n, false);
+  vector<complex<T> > scratch(makhoul.scratch_size());
+  complex<T>* s = &scratch[0];
+  const NaiveDct<T> naive(n, type);
+
+  double ns;
+  ns = timeCall([&]() { codelet(I, O, l.is, l.is, l.v, l.ivs, l.ivs); },
+                min_time_ms);
+  b.report("codelet", ns);
+  ns = timeCall([&]() { simd(I, O, l.is, l.is, l.v, l.ivs, l.ivs); },
+                min_time_ms);
+  b.report("simd", ns);
+  if (type == 2)
+    ns = timeCall([&]() { makhoul.type2(I, O, l.is, l.is, l.v, l.ivs, l.ivs, false, s); },
+                  min_time_ms);
+  else
+    ns = timeCall([&]() { makhoul.type3(I, O, l.is, l.is, l.v, l.ivs, l.ivs, false, s); },
+                  min_time_ms);
+  b.report("makhoul", ns);
+  ns = timeCall([&]() { naive(I, O, l); }, min_time_ms);
+  b.report("naive", ns);
+
+#ifdef QSS_DCT_BENCH_FFTW
+  // planning with FFTW_MEASURE overwrites the arrays
+  Fftw<T> fftw(n, type, l, &b.I[0], O);
+  b.fill();
+  ns = timeCall(fftw, min_time_ms);
+  b.report("fftw", ns);
+#endif
+}
+
+int main(int args, char** argv) {
+  if (args > 2) {
+    cout << "wrong number of input arguments." << endl;
+    help();
+    return 1;
+  }
+  double MIN_TIME_MS = args > 1 ? atof(argv[1]) : 20;
+
+  cout << "vectorized codelets: " << dct_simd_width<float>() << " floats, "
+       << dct_simd_width<double>() << " doubles at once" << endl;
+  cout << "  n  DCT   prec    layout   method  ns/transform  GFLOP/s  "
+          "max rel. error" << endl;
+  const int sizes[] = {48, 64};
+  for (int i = 0; i < 2; i++) {
+    const vector<Layout> l = layouts(sizes[i]);
+    for (int type = 2; type <= 3; type++)
+      for (size_t j = 0; j < l.size(); j++) {
+        run<float>(sizes[i], type, l[j], MIN_TIME_MS);
+        run<double>(sizes[i], type, l[j], MIN_TIME_MS);
+      }
+  }
+  return 0;
+}
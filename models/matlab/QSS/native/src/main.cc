@@ -0,0 +1,366 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <sys/stat.h>
+
+#include "opencv2/opencv.hpp"
+#include "qss.h"
+
+using namespace cv;
+using namespace std;
+
+// defaults of QSS_wrap.m / smiler.json
+#define IM_WIDTH 64
+#define IM_HEIGHT -1
+#define COLOR_SPACE "YCbCr"
+#define NSCALES 1
+#define SCALE_FACTOR 1.2
+#define SMOOTHING_SIZE 9
+#define SMOOTHING_STD 2.5
+
+// images per qdctSaliencyBatch call in folder mode
+#define BATCH_SIZE 32
+
+void help() {
+  cout << "Usage: \n"
+       << "qss_map <input_path> <output_path> [im_width] [im_height] "
+          "[color_space] [nscales] [scale_factor] [smoothing_std] "
+          "[precision]\n"
+       << "  Quaternion DCT image signature saliency of spectral_saliency_"
+          "multichannel.m ('quat:dct:fast', or 'quat:dct:multi' with "
+          "nscales > 1), with the defaults of QSS_wrap.m.\n"
+       << "  input_path, output_path: an image and its saliency map, or a "
+          "folder of images and the folder of their saliency maps "
+          "(<name>.png); the images of a folder with the same working size "
+          "are processed in parallel, in batches of " << BATCH_SIZE << "\n"
+       << "  im_width: width the image is resized to, 0 keeps the native "
+          "resolution (default: " << IM_WIDTH << ")\n"
+       << "  im_height: height the image is resized to, 0 keeps the native "
+          "resolution, -1 keeps the aspect ratio (default: " << IM_HEIGHT
+       << ")\n"
+       << "  color_space: YCbCr, RGB, LAB or HSV (default: " << COLOR_SPACE
+       << ")\n"
+       << "  nscales, scale_factor: scales of 'quat:dct:multi', each "
+          "scale_factor times larger than the previous one (default: "
+       << NSCALES << ", " << SCALE_FACTOR << ")\n"
+       << "  smoothing_std: std. deviation of the " << SMOOTHING_SIZE << "x"
+       << SMOOTHING_SIZE << " gaussian that smoothes the saliency map, 0 "
+          "disables it (default: " << SMOOTHING_STD << ")\n"
+       << "  precision: double or float (default: double)\n";
+}
+
+// the channels of the image in color_space, as MATLAB's conversions of
+// checkImgInput.m of a double image in [0,1]. Returns false for an unknown
+// color space
+static bool convertColorSpace(const Mat& bgr8, const string& color_space,
+                              vector<Mat>& channels) {
+  Mat bgr;
+  bgr8.convertTo(bgr, CV_32FC3, 1.0 / 255);
+  if (color_space == "RGB") {
+    split(bgr, channels);
+    swap(channels[0], channels[2]);
+  } else if (color_space == "YCbCr") {
+    // rgb2ycbcr
+    vector<Mat> c;
+    split(bgr, c);
+    const Mat &R = c[2], &G = c[1], &B = c[0];
+    channels.resize(3);
+    channels[0] = (16 + 65.481 * R + 128.553 * G + 24.966 * B) / 255;
+    channels[1] = (128 - 37.797 * R - 74.203 * G + 112 * B) / 255;
+    channels[2] = (128 + 112 * R - 93.786 * G - 18.214 * B) / 255;
+  } else if (color_space == "LAB") {
+    Mat lab;
+    cvtColor(bgr, lab, COLOR_BGR2Lab);
+    split(lab, channels);
+  } else if (color_space == "HSV") {
+    Mat hsv;
+    cvtColor(bgr, hsv, COLOR_BGR2HSV);
+    split(hsv, channels);
+    channels[0] /= 360;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// OpenCV is row-major, the QSS kernels are column-major with planar channels
+template <typename T>
+static vector<T> toColumnMajor(const vector<Mat>& channels) {
+  const int rows = channels[0].rows, cols = channels[0].cols;
+  vector<T> v((size_t)rows * cols * channels.size());
+  for (size_t c = 0; c < channels.size(); c++) {
+    Mat t;
+    transpose(channels[c], t);
+    t.convertTo(t, sizeof(T) == sizeof(float) ? CV_32F : CV_64F);
+    copy(t.begin<T>(), t.end<T>(), v.begin() + c * rows * cols);
+  }
+  return v;
+}
+
+template <typename T>
+static Mat fromColumnMajor(const vector<T>& v, int rows, int cols) {
+  Mat t(cols, rows, sizeof(T) == sizeof(float) ? CV_32FC1 : CV_64FC1,
+        (void*)&v[0]), m;
+  transpose(t, m);
+  return m;
+}
+
+template <typename T>
+static void mat2gray(vector<T>& S) {
+  const T mn = *min_element(S.begin(), S.end());
+  const T mx = *max_element(S.begin(), S.end());
+  for (size_t i = 0; i < S.size(); i++)
+    S[i] = mx > mn ? (S[i] - mn) / (mx - mn) : T(0);
+}
+
+// the channels resized to rows x cols, column-major (the input of
+// 'quat:dct:fast')
+template <typename T>
+static vector<T> resizedImage(const vector<Mat>& channels, int rows,
+                              int cols) {
+  const int R = channels[0].rows, C = channels[0].cols;
+  const int nchannels = (int)channels.size();
+  vector<T> I = toColumnMajor<T>(channels);
+  vector<T> IR((size_t)rows * cols * nchannels);
+  for (int c = 0; c < nchannels; c++)
+    imresizeBicubic(&I[(size_t)c * R * C], &IR[(size_t)c * rows * cols], R,
+                    C, rows, cols);
+  return IR;
+}
+
+// the smoothed rows x cols saliency S in [0,1], resized to R x C
+template <typename T>
+static Mat postprocess(const T* S, int rows, int cols, int R, int C,
+                       double smoothing_std) {
+  // imfilter(S, fspecial('gaussian', 9, smoothing_std)): zero padding
+  Mat smap = fromColumnMajor(vector<T>(S, S + (size_t)rows * cols), rows,
+                             cols);
+  if (smoothing_std > 0) {
+    Mat g = getGaussianKernel(SMOOTHING_SIZE, smoothing_std, smap.depth());
+    sepFilter2D(smap, smap, -1, g, g, Point(-1, -1), 0, BORDER_CONSTANT);
+  }
+  vector<T> SF = toColumnMajor<T>(vector<Mat>(1, smap));
+  mat2gray(SF);
+
+  // imresize(salmap, size of the input image)
+  vector<T> out((size_t)R * C);
+  imresizeBicubic(&SF[0], &out[0], rows, cols, R, C);
+  return fromColumnMajor(out, R, C).clone();
+}
+
+// the saliency map of QSS_wrap.m at the size of the input image, in [0,1]
+// (up to the overshoot of the bicubic upsampling)
+template <typename T>
+static Mat saliency(const vector<Mat>& channels, int rows, int cols,
+                    int nscales, double scale_factor, double smoothing_std) {
+  const int R = channels[0].rows, C = channels[0].cols;
+  const int nchannels = (int)channels.size();
+  vector<T> S((size_t)rows * cols);
+
+  if (nscales > 1) {
+    // 'quat:dct:multi': the scales are resized from the input image;
+    // QSS_wrap.m leaves the range normalization to SMILER
+    vector<T> I = toColumnMajor<T>(channels);
+    qdctSaliencyMultiscale(&I[0], R, C, nchannels,
+                           qdctScales(rows, cols, nscales, scale_factor),
+                           rows, cols, &S[0], (const T*)0, T(2), false, false);
+  } else {
+    // 'quat:dct:fast'
+    vector<T> IR = resizedImage<T>(channels, rows, cols);
+    qdctSaliency(&IR[0], rows, cols, nchannels, &S[0]);
+  }
+  return postprocess(&S[0], rows, cols, R, C, smoothing_std);
+}
+
+// an image of a folder, converted and waiting for its batch
+struct FolderImage {
+  string out_path;
+  vector<Mat> channels;
+};
+
+// 'quat:dct:fast' of images with the same working size rows x cols (and
+// number of channels) at once: qdctSaliencyBatch computes the saliency of
+// the images in parallel. Writes the saliency maps and empties images
+template <typename T>
+static void saliencyBatch(vector<FolderImage>& images, int rows, int cols,
+                          double smoothing_std) {
+  if (images.empty())
+    return;
+  const int nchannels = (int)images[0].channels.size();
+  const size_t size = (size_t)rows * cols * nchannels;
+  vector<T> IR(size * images.size());
+  for (size_t i = 0; i < images.size(); i++) {
+    vector<T> I = resizedImage<T>(images[i].channels, rows, cols);
+    copy(I.begin(), I.end(), IR.begin() + i * size);
+  }
+  vector<T> S((size_t)rows * cols * images.size());
+  qdctSaliencyBatch(&IR[0], rows, cols, nchannels, (int)images.size(), &S[0]);
+  for (size_t i = 0; i < images.size(); i++) {
+    const vector<Mat>& channels = images[i].channels;
+    Mat sal = postprocess(&S[i * rows * cols], rows, cols, channels[0].rows,
+                          channels[0].cols, smoothing_std);
+    Mat result;
+    sal.convertTo(result, CV_8UC1, 255.0);
+    imwrite(images[i].out_path, result);
+  }
+  images.clear();
+}
+
+static bool isDirectory(const string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// the extensions of the images of a folder, as in BMS
+static bool isImageFile(const string& path) {
+  const size_t dot = path.rfind('.');
+  if (dot == string::npos)
+    return false;
+  const string ext = path.substr(dot + 1);
+  return ext == "jpg" || ext == "jpeg" || ext == "JPG" || ext == "tif" ||
+         ext == "png" || ext == "bmp";
+}
+
+// <folder>/<name of path without extension>.png
+static string outputPath(const string& folder, const string& path) {
+  const size_t slash = path.find_last_of("/\\");
+  string name = slash == string::npos ? path : path.substr(slash + 1);
+  name = name.substr(0, name.rfind('.'));
+  return folder + "/" + name + ".png";
+}
+
+// imsize of QSS_wrap.m; a NaN height is ceil(scale * rows), as imresize
+static void workingSize(const Mat& src, int im_width, int im_height,
+                        int& rows, int& cols) {
+  cols = im_width > 0 ? im_width : src.cols;
+  rows = im_height > 0 ? im_height : src.rows;
+  if (im_height < 0)
+    rows = (int)ceil((double)cols / src.cols * src.rows);
+}
+
+// the saliency maps of the images of in_folder as <name>.png in out_folder;
+// 'quat:dct:fast' collects the images of the same working size into batches
+// of BATCH_SIZE. Returns false for an unknown color space
+template <typename T>
+static bool processFolder(const string& in_folder, const string& out_folder,
+                          int im_width, int im_height,
+                          const string& color_space, int nscales,
+                          double scale_factor, double smoothing_std) {
+  vector<String> files;
+  glob(in_folder, files, false);
+  map<pair<int, int>, vector<FolderImage> > batches;
+  for (size_t i = 0; i < files.size(); i++) {
+    if (!isImageFile(files[i]))
+      continue;
+    Mat src = imread(files[i], IMREAD_COLOR);
+    if (src.empty()) {
+      cerr << "could not read " << files[i] << endl;
+      continue;
+    }
+    FolderImage image;
+    image.out_path = outputPath(out_folder, files[i]);
+    if (!convertColorSpace(src, color_space, image.channels))
+      return false;
+    int rows, cols;
+    workingSize(src, im_width, im_height, rows, cols);
+
+    if (nscales > 1) {
+      Mat result;
+      saliency<T>(image.channels, rows, cols, nscales, scale_factor,
+                  smoothing_std).convertTo(result, CV_8UC1, 255.0);
+      imwrite(image.out_path, result);
+      continue;
+    }
+    vector<FolderImage>& batch = batches[make_pair(rows, cols)];
+    batch.push_back(image);
+    if ((int)batch.size() == BATCH_SIZE)
+      saliencyBatch<T>(batch, rows, cols, smoothing_std);
+  }
+  for (map<pair<int, int>, vector<FolderImage> >::iterator b = batches.begin();
+       b != batches.end(); ++b)
+    saliencyBatch<T>(b->second, b->first.first, b->first.second,
+                     smoothing_std);
+  return true;
+}
+
+int main(int args, char** argv) {
+  if (args < 3) {
+    cout << "wrong number of input arguments." << endl;
+    help();
+    return 1;
+  }
+
+  string INPUT_PATH = argv[1];
+  string OUTPUT_PATH = argv[2];
+  int IMWIDTH = args > 3 ? atoi(argv[3]) : IM_WIDTH;
+  int IMHEIGHT = args > 4 ? atoi(argv[4]) : IM_HEIGHT;
+  string COLORSPACE = args > 5 ? argv[5] : COLOR_SPACE;
+  int NUM_SCALES = args > 6 ? atoi(argv[6]) : NSCALES;
+  double SCALEFACTOR = args > 7 ? atof(argv[7]) : SCALE_FACTOR;
+  double SMOOTHING = args > 8 ? atof(argv[8]) : SMOOTHING_STD;
+  string PRECISION = args > 9 ? argv[9] : "double";
+  if (PRECISION != "double" && PRECISION != "float") {
+    cout << "unknown precision " << PRECISION << endl;
+    help();
+    return 1;
+  }
+  if (NUM_SCALES < 1 || SCALEFACTOR <= 0) {
+    cout << "nscales must be >= 1 and scale_factor > 0" << endl;
+    help();
+    return 1;
+  }
+
+  if (isDirectory(INPUT_PATH)) {
+    if (INPUT_PATH == OUTPUT_PATH || !isDirectory(OUTPUT_PATH)) {
+      cerr << "the output path must be a folder other than the input folder"
+           << endl;
+      return 1;
+    }
+    const bool ok =
+        PRECISION == "float"
+            ? processFolder<float>(INPUT_PATH, OUTPUT_PATH, IMWIDTH, IMHEIGHT,
+                                   COLORSPACE, NUM_SCALES, SCALEFACTOR,
+                                   SMOOTHING)
+            : processFolder<double>(INPUT_PATH, OUTPUT_PATH, IMWIDTH,
+                                    IMHEIGHT, COLORSPACE, NUM_SCALES,
+                                    SCALEFACTOR, SMOOTHING);
+    if (!ok) {
+      cout << "unknown color space " << COLORSPACE << endl;
+      help();
+      return 1;
+    }
+    return 0;
+  }
+
+  Mat src = imread(INPUT_PATH, IMREAD_COLOR);
+  if (src.empty()) {
+    cerr << "could not read " << INPUT_PATH << endl;
+    return 1;
+  }
+  vector<Mat> channels;
+  if (!convertColorSpace(src, COLORSPACE, channels)) {
+    cout << "unknown color space " << COLORSPACE << endl;
+    help();
+    return 1;
+  }
+
+  int rows, cols;
+  workingSize(src, IMWIDTH, IMHEIGHT, rows, cols);
+
+  Mat sal = PRECISION == "float"
+                ? saliency<float>(channels, rows, cols, NUM_SCALES,
+                                  SCALEFACTOR, SMOOTHING)
+                : saliency<double>(channels, rows, cols, NUM_SCALES,
+                                   SCALEFACTOR, SMOOTHING);
+
+  Mat result;
+  sal.convertTo(result, CV_8UC1, 255.0);
+  imwrite(OUTPUT_PATH, result);
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+#include <math.h>
+#include <vector>
+#include <stdexcept>
+
+#include "qss.h"
+#include "qdct_saliency.hpp"
+#include "qdct_saliency_multiscale.hpp"
+#include "imresize.hpp"
+
+template <typename T>
+static void defaultAxis(T axis[4]) {
+  axis[0] = 0;
+  axis[1] = axis[2] = axis[3] = T(-1) / sqrt(T(3));
+}
+
+void qdctDefaultAxis(double axis[4]) { defaultAxis(axis); }
+void qdctDefaultAxis(float axis[4]) { defaultAxis(axis); }
+
+// the kernels only take pure (3 channel) and full (4 channel) quaternions
+static void checkChannels(int channels) {
+  if (channels != 3 && channels != 4)
+    throw std::invalid_argument("qss: the image must have 3 or 4 channels");
+}
+
+// axis, or the default axis (in tmp) if axis is 0
+template <typename T>
+static const T* axisOrDefault(const T* axis, T tmp[4]) {
+  if (axis)
+    return axis;
+  defaultAxis(tmp);
+  return tmp;
+}
+
+template <typename T>
+static void saliency(const T* image, int rows, int cols, int channels,
+                     T* sal, const T* axis, bool normalize) {
+  checkChannels(channels);
+  T tmp[4];
+  qdct_saliency(axisOrDefault(axis, tmp), image, sal, rows, cols, channels,
+                normalize);
+}
+
+void qdctSaliency(const double* image, int rows, int cols, int channels,
+                  double* sal, const double* axis, bool normalize) {
+  saliency(image, rows, cols, channels, sal, axis, normalize);
+}
+
+void qdctSaliency(const float* image, int rows, int cols, int channels,
+                  float* sal, const float* axis, bool normalize) {
+  saliency(image, rows, cols, channels, sal, axis, normalize);
+}
+
+template <typename T>
+static void saliencyBatch(const T* images, int rows, int cols, int channels,
+                          int count, T* sal, const T* axis, bool normalize) {
+  checkChannels(channels);
+  T tmp[4];
+  qdct_saliency_batch(axisOrDefault(axis, tmp), images, sal, rows, cols,
+                      channels, count, normalize);
+}
+
+void qdctSaliencyBatch(const double* images, int rows, int cols, int channels,
+                       int count, double* sal, const double* axis,
+                       bool normalize) {
+  saliencyBatch(images, rows, cols, channels, count, sal, axis, normalize);
+}
+
+void qdctSaliencyBatch(const float* images, int rows, int cols, int channels,
+                       int count, float* sal, const float* axis,
+                       bool normalize) {
+  saliencyBatch(images, rows, cols, channels, count, sal, axis, normalize);
+}
+
+// see the resolutions of 'quat:dct:multi' in spectral_saliency_multichannel.m;
+// the sizes are rounded up as by qdct_saliency_multiscale
+std::vector<int> qdctScales(int rows, int cols, int nscales,
+                            double scale_factor, bool downscaling) {
+  std::vector<int> sizes;
+  double r = rows, c = cols;
+  for (int s = 0; s < nscales; s++) {
+    sizes.push_back((int)ceil(r));
+    sizes.push_back((int)ceil(c));
+    r = downscaling ? r / scale_factor : r * scale_factor;
+    c = downscaling ? c / scale_factor : c * scale_factor;
+  }
+  return sizes;
+}
+
+template <typename T>
+static void saliencyMultiscale(const T* image, int rows, int cols,
+                               int channels, const std::vector<int>& sizes,
+                               int target_rows, int target_cols, T* sal,
+                               const T* axis, T absexp, bool normalize,
+                               bool range_normalization) {
+  checkChannels(channels);
+  // the sum over no scales (or of empty maps) is undefined
+  bool valid = !sizes.empty() && sizes.size() % 2 == 0 && target_rows > 0 &&
+               target_cols > 0;
+  for (size_t i = 0; i < sizes.size() && valid; i++)
+    valid = sizes[i] > 0;
+  if (!valid)
+    throw std::invalid_argument(
+        "qss: the scales and the target size must be non-empty and positive");
+  T tmp[4];
+  qdct_saliency_multiscale(axisOrDefault(axis, tmp), image, rows, cols,
+                           channels, &sizes[0], (int)sizes.size() / 2,
+                           target_rows, target_cols, absexp, normalize,
+                           range_normalization, sal);
+}
+
+void qdctSaliencyMultiscale(const double* image, int rows, int cols,
+                            int channels, const std::vector<int>& sizes,
+                            int target_rows, int target_cols, double* sal,
+                            const double* axis, double absexp, bool normalize,
+                            bool range_normalization) {
+  saliencyMultiscale(image, rows, cols, channels, sizes, target_rows,
+                     target_cols, sal, axis, absexp, normalize,
+                     range_normalization);
+}
+
+void qdctSaliencyMultiscale(const float* image, int rows, int cols,
+                            int channels, const std::vector<int>& sizes,
+                            int target_rows, int target_cols, float* sal,
+                            const float* axis, float absexp, bool normalize,
+                            bool range_normalization) {
+  saliencyMultiscale(image, rows, cols, channels, sizes, target_rows,
+                     target_cols, sal, axis, absexp, normalize,
+                     range_normalization);
+}
+
+void dct2(const double* in, double* out, int rows, int cols, bool normalize) {
+  dct2_type2(in, out, rows, cols, normalize);
+}
+
+void dct2(const float* in, float* out, int rows, int cols, bool normalize) {
+  dct2_type2(in, out, rows, cols, normalize);
+}
+
+void idct2(const double* in, double* out, int rows, int cols, bool normalize) {
+  idct2_type2(in, out, rows, cols, normalize);
+}
+
+void idct2(const float* in, float* out, int rows, int cols, bool normalize) {
+  idct2_type2(in, out, rows, cols, normalize);
+}
+
+template <typename T>
+static void signum(const T* q, T* out, int rows, int cols, int channels,
+                   T scale) {
+  checkChannels(channels);
+  if (channels == 3)
+    ScaledSignumSimd_3c(q, out, scale, rows, cols);
+  else
+    ScaledSignumSimd_4c(q, out, scale, rows, cols);
+}
+
+void quaternionSignum(const double* q, double* out, int rows, int cols,
+                      int channels, double scale) {
+  signum(q, out, rows, cols, channels, scale);
+}
+
+void quaternionSignum(const float* q, float* out, int rows, int cols,
+                      int channels, float scale) {
+  signum(q, out, rows, cols, channels, scale);
+}
+
+template <typename T>
+static void absSqr(const T* q, T* out, int rows, int cols, int channels) {
+  checkChannels(channels);
+  if (channels == 3)
+    AbsSqrSimd_3c(q, out, rows, cols);
+  else
+    AbsSqrSimd_4c(q, out, rows, cols);
+}
+
+void quaternionAbsSqr(const double* q, double* out, int rows, int cols,
+                      int channels) {
+  absSqr(q, out, rows, cols, channels);
+}
+
+void quaternionAbsSqr(const float* q, float* out, int rows, int cols,
+                      int channels) {
+  absSqr(q, out, rows, cols, channels);
+}
+
+void imresizeBicubic(const double* in, double* out, int rows, int cols,
+                     int new_rows, int new_cols) {
+  ImresizeBicubic(in, out, rows, cols, new_rows, new_cols);
+}
+
+void imresizeBicubic(const float* in, float* out, int rows, int cols,
+                     int new_rows, int new_cols) {
+  ImresizeBicubic(in, out, rows, cols, new_rows, new_cols);
+}
@@ -0,0 +1,102 @@
+#ifndef QSS_NATIVE_H
+#define QSS_NATIVE_H
+
+#include <vector>
+
+// Native (MATLAB-free) interface of the quaternion DCT image signature
+// saliency, built on the same headers as the mex functions in ../qdct_impl.
+// Images are column-major arrays (rows x cols), as in MATLAB; the channels
+// of an image and the images of a stack follow one after another
+// (rows x cols x channels x count). Every function exists for float and
+// double. The functions that take quaternion images throw
+// std::invalid_argument unless channels is 3 or 4.
+
+// the default axis of spectral_saliency_multichannel, unit(quaternion(-1,-1,-1)),
+// as [0 x y z]
+void qdctDefaultAxis(double axis[4]);
+void qdctDefaultAxis(float axis[4]);
+
+// S = qdct_saliency(I, axis, normalize): the squared absolute value of the
+// IQDCT of the signum of the QDCT of an image with 3 (pure quaternion) or 4
+// channels. axis 0 => qdctDefaultAxis. With normalize, the DCTs are
+// orthonormal (as qdct2 of the QTFM, i.e. the 'quat:dct' saliency).
+void qdctSaliency(const double* image, int rows, int cols, int channels,
+                  double* saliency, const double* axis = 0,
+                  bool normalize = false);
+void qdctSaliency(const float* image, int rows, int cols, int channels,
+                  float* saliency, const float* axis = 0,
+                  bool normalize = false);
+
+// qdctSaliency of each of count images of the same size (e.g. the frames of a
+// video); saliency is rows x cols x count. The images run in parallel
+// (OpenMP). The temporary data is reused across calls by the same thread
+// (thread_local, freed when the thread exits); any thread may call these
+// functions concurrently.
+void qdctSaliencyBatch(const double* images, int rows, int cols, int channels,
+                       int count, double* saliency, const double* axis = 0,
+                       bool normalize = false);
+void qdctSaliencyBatch(const float* images, int rows, int cols, int channels,
+                       int count, float* saliency, const float* axis = 0,
+                       bool normalize = false);
+
+// the image sizes of the scales of 'quat:dct:multi' (rows_1, cols_1,
+// rows_2, cols_2, ...): the first scale is rows x cols, each further one
+// scale_factor times larger (or smaller, with downscaling)
+std::vector<int> qdctScales(int rows, int cols, int nscales,
+                            double scale_factor, bool downscaling = false);
+
+// the multi-scale saliency of 'quat:dct:multi' (qdct_saliency_multiscale):
+// the image is resized to each scale of sizes (see qdctScales), its
+// saliency (normalized DCTs, |.|^absexp, optionally scaled to [0,1] with
+// normalize) is resized to target_rows x target_cols, optionally scaled to
+// [0,1] with range_normalization, and the maps are summed. The scales run
+// in parallel (OpenMP). Throws std::invalid_argument for no scales or sizes
+// that are not positive.
+void qdctSaliencyMultiscale(const double* image, int rows, int cols,
+                            int channels, const std::vector<int>& sizes,
+                            int target_rows, int target_cols, double* saliency,
+                            const double* axis = 0, double absexp = 2,
+                            bool normalize = false,
+                            bool range_normalization = true);
+void qdctSaliencyMultiscale(const float* image, int rows, int cols,
+                            int channels, const std::vector<int>& sizes,
+                            int target_rows, int target_cols, float* saliency,
+                            const float* axis = 0, float absexp = 2,
+                            bool normalize = false,
+                            bool range_normalization = true);
+
+// the primitives of the saliency
+
+// 2-D type-II DCT (dct2) and its inverse (idct2) of a rows x cols matrix;
+// orthonormal with normalize (as MATLAB), otherwise the unnormalized
+// transforms of FFTW (REDFT10 / REDFT01). in and out may be the same.
+void dct2(const double* in, double* out, int rows, int cols,
+          bool normalize = true);
+void dct2(const float* in, float* out, int rows, int cols,
+          bool normalize = true);
+void idct2(const double* in, double* out, int rows, int cols,
+           bool normalize = true);
+void idct2(const float* in, float* out, int rows, int cols,
+           bool normalize = true);
+
+// scale * q / |q| of each element of a quaternion image with 3 (pure) or 4
+// channels (0 where |q| = 0); q and out may be the same
+void quaternionSignum(const double* q, double* out, int rows, int cols,
+                      int channels, double scale = 1);
+void quaternionSignum(const float* q, float* out, int rows, int cols,
+                      int channels, float scale = 1);
+
+// |q|^2 of each element of a quaternion image with 3 (pure) or 4 channels;
+// out is rows x cols
+void quaternionAbsSqr(const double* q, double* out, int rows, int cols,
+                      int channels);
+void quaternionAbsSqr(const float* q, float* out, int rows, int cols,
+                      int channels);
+
+// imresize(A, [new_rows new_cols], 'bicubic') of one channel
+void imresizeBicubic(const double* in, double* out, int rows, int cols,
+                     int new_rows, int new_cols);
+void imresizeBicubic(const float* in, float* out, int rows, int cols,
+                     int new_rows, int new_cols);
+
+#endif
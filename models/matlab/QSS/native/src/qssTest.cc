@@ -0,0 +1,116 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+
+#include "qss.h"
+
+using namespace std;
+
+// Checks qdctSaliency (the fused implementation of qdct_saliency.hpp) against
+// the QDCT saliency computed step by step from the primitives of qss.h,
+//   |IDCT(mu * signum(DCT(mu * I)))|^2,
+// for the default axis and other (non-default, non-pure) axes, 3 and 4
+// channels and sizes with and without the 48/64 codelets, and that other
+// channel counts and empty scale lists are rejected. Exits with 1 on a failure.
+
+// c = a * b (Hamilton product) of two quaternions [w x y z]
+static void hamilton(const double* a, const double* b, double* c) {
+  c[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+  c[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+  c[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+  c[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+}
+
+// mu * q of each element of a 4 channel quaternion image (in place)
+static void multiplyAxis(const double* mu, vector<double>& q, int n) {
+  for (int i = 0; i < n; i++) {
+    double a[4], c[4];
+    for (int ch = 0; ch < 4; ch++)
+      a[ch] = q[ch * n + i];
+    hamilton(mu, a, c);
+    for (int ch = 0; ch < 4; ch++)
+      q[ch * n + i] = c[ch];
+  }
+}
+
+static void referenceSaliency(const vector<double>& image, int rows, int cols,
+                              int channels, const double* mu,
+                              vector<double>& sal) {
+  const int n = rows * cols;
+  // the image as a full quaternion image (a pure one for 3 channels)
+  vector<double> q(4 * n, 0.0);
+  copy(image.begin(), image.end(), q.begin() + (channels == 3 ? n : 0));
+  multiplyAxis(mu, q, n);
+  for (int ch = 0; ch < 4; ch++)
+    dct2(&q[ch * n], &q[ch * n], rows, cols, true);
+  quaternionSignum(&q[0], &q[0], rows, cols, 4);
+  multiplyAxis(mu, q, n);
+  for (int ch = 0; ch < 4; ch++)
+    idct2(&q[ch * n], &q[ch * n], rows, cols, true);
+  sal.resize(n);
+  quaternionAbsSqr(&q[0], &sal[0], rows, cols, 4);
+}
+
+int main() {
+  double axes[][4] = {
+    { 0, 0, 0, 0 },            // replaced by qdctDefaultAxis
+    { 0, 0, 0, 1 },            // quaternion(0,0,1), e.g. a user-set dctaxis
+    { 0, 1, 0, 0 },
+    { 0, 0.6, 0, -0.8 },
+    { 0.5, 0.5, -0.5, 0.5 },   // not pure
+  };
+  qdctDefaultAxis(axes[0]);
+  const int sizes[][2] = { { 48, 64 }, { 37, 50 }, { 58, 77 } };
+
+  srand(1);
+  int failures = 0;
+  for (int s = 0; s < 3; s++) {
+    const int rows = sizes[s][0], cols = sizes[s][1];
+    for (int channels = 3; channels <= 4; channels++) {
+      vector<double> image(rows * cols * channels);
+      for (size_t i = 0; i < image.size(); i++)
+        image[i] = rand() / (double)RAND_MAX;
+      for (int a = 0; a < 5; a++) {
+        vector<double> sal(rows * cols), ref;
+        qdctSaliency(&image[0], rows, cols, channels, &sal[0], axes[a], true);
+        referenceSaliency(image, rows, cols, channels, axes[a], ref);
+        double err = 0, range = 0;
+        for (int i = 0; i < rows * cols; i++) {
+          err = max(err, fabs(sal[i] - ref[i]));
+          range = max(range, fabs(ref[i]));
+        }
+        const bool ok = range > 0 && err <= 1e-9 * range;
+        if (!ok)
+          failures++;
+        cout << (ok ? "ok   " : "FAIL ") << rows << "x" << cols << "x"
+             << channels << " axis [" << axes[a][0] << " " << axes[a][1]
+             << " " << axes[a][2] << " " << axes[a][3]
+             << "]: max. difference " << err << " of " << range << endl;
+      }
+    }
+  }
+
+  // only 3 and 4 channels are quaternion images
+  try {
+    vector<double> image(48 * 64 * 2), sal(48 * 64);
+    qdctSaliency(&image[0], 48, 64, 2, &sal[0]);
+    failures++;
+    cout << "FAIL 48x64x2 was not rejected" << endl;
+  } catch (const invalid_argument&) {
+    cout << "ok   48x64x2 rejected" << endl;
+  }
+  // as there are no scales to sum
+  try {
+    vector<double> image(48 * 64 * 3), sal(48 * 64);
+    qdctSaliencyMultiscale(&image[0], 48, 64, 3, vector<int>(), 48, 64,
+                           &sal[0]);
+    failures++;
+    cout << "FAIL multiscale without scales was not rejected" << endl;
+  } catch (const invalid_argument&) {
+    cout << "ok   multiscale without scales rejected" << endl;
+  }
+  return failures ? 1 : 0;
+}
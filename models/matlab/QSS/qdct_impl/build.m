@@ -1,4 +1,7 @@
-% Build the hard-coded 48x64 Quaternion DCT saliency .mex-interface
+% Build the hard-coded 48x64 Quaternion DCT saliency .mex-interface,
+% qdct_saliency, which takes images of any size (see dct_plan.hpp) or stacks
+% of images, and qdct_saliency_multiscale (OpenMP parallelizes the images of
+% a stack and the scales)
 % (if you want faster code, then you should add further optimization
 %  parameters to the mex compiler)
 %
@@ -11,21 +14,25 @@ mex -c dct_type2_48.cpp
 mex -c dct_type2_64.cpp
 mex -c dct_type3_48.cpp
 mex -c dct_type3_64.cpp
+% ... and their vectorized versions (dct_simd.hpp; runtime dispatch, no flags)
+mex -c dct_simd.cpp
 
 % compile the .mex-files/interfaces
 if ispc
     % for use with Visual Studio / Windows SDK under Windows
-    mex -D__MEX dct_48_64.cpp dct_type2_48.obj dct_type2_64.obj dct_type3_48.obj dct_type3_64.obj
+    mex -D__MEX dct_48_64.cpp dct_type2_48.obj dct_type2_64.obj dct_type3_48.obj dct_type3_64.obj dct_simd.obj
     mex -D__MEX hamilton_product.cpp 
     mex -D__MEX signum.cpp 
-    mex -c dct_48_64.cpp
-    mex -D__MEX qdct_saliency_48_64_nofilter.cpp dct_type2_48.obj dct_type2_64.obj dct_type3_48.obj dct_type3_64.obj dct_48_64.obj -output qdct_saliency_48_64
+    mex -D__MEX qdct_saliency_48_64_nofilter.cpp dct_type2_48.obj dct_type2_64.obj dct_type3_48.obj dct_type3_64.obj dct_simd.obj -output qdct_saliency_48_64
+    mex -D__MEX COMPFLAGS="$COMPFLAGS /openmp" qdct_saliency_nofilter.cpp dct_type2_48.obj dct_type2_64.obj dct_type3_48.obj dct_type3_64.obj dct_simd.obj -output qdct_saliency
+    mex -D__MEX COMPFLAGS="$COMPFLAGS /openmp" qdct_saliency_multiscale.cpp dct_type2_48.obj dct_type2_64.obj dct_type3_48.obj dct_type3_64.obj dct_simd.obj -output qdct_saliency_multiscale
     delete *.obj % clean-up the temporary object files
 else
     % for use with GCC under Linux
-    mex -D__MEX dct_48_64.cpp dct_type2_48.o dct_type2_64.o dct_type3_48.o dct_type3_64.o
+    mex -D__MEX dct_48_64.cpp dct_type2_48.o dct_type2_64.o dct_type3_48.o dct_type3_64.o dct_simd.o
     mex -D__MEX hamilton_product.cpp 
     mex -D__MEX signum.cpp 
-    mex -c dct_48_64.cpp
-    mex -D__MEX qdct_saliency_48_64_nofilter.cpp dct_type2_48.o dct_type2_64.o dct_type3_48.o dct_type3_64.o dct_48_64.o -o qdct_saliency_48_64
+    mex -D__MEX qdct_saliency_48_64_nofilter.cpp dct_type2_48.o dct_type2_64.o dct_type3_48.o dct_type3_64.o dct_simd.o -o qdct_saliency_48_64
+    mex -D__MEX CXXFLAGS="$CXXFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" qdct_saliency_nofilter.cpp dct_type2_48.o dct_type2_64.o dct_type3_48.o dct_type3_64.o dct_simd.o -o qdct_saliency
+    mex -D__MEX CXXFLAGS="$CXXFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" qdct_saliency_multiscale.cpp dct_type2_48.o dct_type2_64.o dct_type3_48.o dct_type3_64.o dct_simd.o -o qdct_saliency_multiscale
 end
@@ -50,11 +50,8 @@
  * \date   2011
  */
 
-// @TODO:
-// - The normalization is broken at the moment. Needs to be fixed!
-// 
-
 #include "dct_type2.hpp"
+#include "dct_simd.hpp"
 
 #include "dct_48_64.hpp"
 
@@ -84,7 +81,7 @@ dct1_type2_48_64(const T* indata, T* outdata, bool do_normalization)
     const T T_M2 = sqrt(T(2)/T(M)) / T(2);
     
    // 1-D debug code (compare with matlab dct function)
-    dct_type2_48(indata,outdata,1,1,(int)N,(int)M,(int)M);
+    dct_type2_48_simd(indata,outdata,1,1,(int)N,(int)M,(int)M);
     // normalization
     if (do_normalization)
     {
@@ -114,8 +111,13 @@ dct2_type2_48_64(const T* indata, T* outdata, bool do_normalization)
     const T T_M2 = sqrt(T(2)/T(M)) / T(2);
     T tmpdata[M*N];
 
+    // blocked, with the normalization folded into the column pass (if the
+    // CPU has vectorized codelets)
+    if (dct2_type2_simd(indata, outdata, M, N, do_normalization, tmpdata))
+      return;
+
     // real code    
-    dct_type2_64(indata,tmpdata,(int)M,(int)M,(int)M,1,1);
+    dct_type2_64_simd(indata,tmpdata,(int)M,(int)M,(int)M,1,1);
     // 1st normalization (normalize each row)
     if (do_normalization)
     {
@@ -128,7 +130,7 @@ dct2_type2_48_64(const T* indata, T* outdata, bool do_normalization)
             }
         }
     }  
-    dct_type2_48(tmpdata,outdata,1,1,(int)N,(int)M,(int)M);
+    dct_type2_48_simd(tmpdata,outdata,1,1,(int)N,(int)M,(int)M);
     // 2nd normalization (normalize each column)
     if (do_normalization)
     {
@@ -165,7 +167,7 @@ idct1_type2_48_64(const T* indata, T* outdata, bool do_normalization) // actuall
           tmpdata[x*M] = indata[x*M] * sqrt(T(2));
           for (int y = 1; y < M; y++)
           {
-            tmpdata[x*M + y] = indata[x*M];
+            tmpdata[x*M + y] = indata[x*M + y];
           }
         
           //tmpdata[x*M] = indata[x*M] * sqrt(1/T(M)) / T(2);
@@ -178,9 +180,9 @@ idct1_type2_48_64(const T* indata, T* outdata, bool do_normalization) // actuall
     
     // calculate the dct-III
     if (do_normalization)
-      dct_type3_48(tmpdata,outdata,1,1,(int)N,(int)M,(int)M);
+      dct_type3_48_simd(tmpdata,outdata,1,1,(int)N,(int)M,(int)M);
     else
-      dct_type3_48(indata,outdata,1,1,(int)N,(int)M,(int)M);
+      dct_type3_48_simd(indata,outdata,1,1,(int)N,(int)M,(int)M);
     
     // post-normalization, i.e. multiply by sqrt(2/M)
     if (do_normalization)
@@ -213,6 +215,11 @@ idct2_type2_48_64(const T* indata, T* outdata, bool do_normalization) // actuall
     T tmpdata_a[M*N];
     T tmpdata_b[M*N];
     
+    // blocked, with the normalization folded into the column pass (if the
+    // CPU has vectorized codelets)
+    if (idct2_type2_simd(indata, outdata, M, N, do_normalization, tmpdata_a))
+      return;
+    
     ////
     // 1st dimension
     ////
@@ -225,16 +232,16 @@ idct2_type2_48_64(const T* indata, T* outdata, bool do_normalization) // actuall
           tmpdata_a[x*M] = indata[x*M] * sqrt(T(2));
           for (int y = 1; y < M; y++)
           {
-            tmpdata_a[x*M + y] = indata[x*M];
+            tmpdata_a[x*M + y] = indata[x*M + y];
           }
       }
     }
     
     // calculate the dct-III
     if (do_pre_normalization)
-      dct_type3_48(tmpdata_a,tmpdata_b,1,1,(int)N,(int)M,(int)M);
+      dct_type3_48_simd(tmpdata_a,tmpdata_b,1,1,(int)N,(int)M,(int)M);
     else
-      dct_type3_48(indata,tmpdata_b,1,1,(int)N,(int)M,(int)M);
+      dct_type3_48_simd(indata,tmpdata_b,1,1,(int)N,(int)M,(int)M);
     
     // post-normalization, i.e. multiply by sqrt(2/M)
     if (do_post_normalization)
@@ -262,7 +269,7 @@ idct2_type2_48_64(const T* indata, T* outdata, bool do_normalization) // actuall
     }
     
     // calculate the dct-III
-    dct_type3_64(tmpdata_b,outdata,(int)M,(int)M,(int)M,1,1);
+    dct_type3_64_simd(tmpdata_b,outdata,(int)M,(int)M,(int)M,1,1);
     
     // post-normalization, i.e. multiply by sqrt(2/M)
     if (do_post_normalization)
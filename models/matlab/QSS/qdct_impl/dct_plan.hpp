@@ -0,0 +1,710 @@
+/**
+ * Planned type-II DCT and type-III DCT (its inverse) for arbitrary sizes.
+ *
+ * The hard-coded codelets (dct_type2.hpp) exist only for 48 and 64 element
+ * arrays. A DctPlan transforms arrays of any length n and is built once per
+ * size; GetDctPlan caches the plans, so that a multi-resolution run pays for
+ * the twiddle factors of each size only once.
+ *
+ * Implementation notes:
+ * --------------------
+ * - lengths 48 and 64 are dispatched to the hard-coded codelets, vectorized
+ *   over the v transforms where the CPU allows it (dct_simd.hpp)
+ * - lengths up to DCT_PLAN_DIRECT_MAX are a product with the n x n cosine
+ *   matrix, which beats an FFT of these lengths; the arrays are the inner
+ *   loop where they are adjacent (e.g. the rows of a matrix), so it is
+ *   vectorized over the transforms
+ * - all other lengths use Makhoul's algorithm, i.e. one complex FFT of
+ *   length n per transform. The FFT is a mixed-radix (4, 2, 3, 5, ...)
+ *   decimation-in-time FFT; lengths with a prime factor larger than
+ *   DCT_PLAN_MAX_RADIX use Bluestein's algorithm with a power of two FFT
+ * - complex products are written out (CMul): the operator* of std::complex
+ *   checks for infinities and NaNs (C99 Annex G) and calls __muldc3 then
+ * - the unnormalized transforms follow the FFTW conventions of the codelets:
+ *     type-II:  X_k = 2 sum_j x_j cos(pi k (2j+1) / (2n))          (REDFT10)
+ *     type-III: y_j = X_0 + 2 sum_k X_k cos(pi k (2j+1) / (2n))    (REDFT01)
+ *   with do_normalization, they are orthonormal (as Matlab's dct and idct)
+ * - the (stride, count) interface is the one of the codelets: v arrays of
+ *   n elements with element strides is/os, the arrays ivs/ovs apart
+ */
+#pragma once
+
+#include "dct_type2.hpp"
+#include "dct_simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * Largest prime factor that the mixed-radix FFT handles directly (its
+ * butterflies are O(p^2)); lengths with larger ones use Bluestein.
+ */
+#ifndef DCT_PLAN_MAX_RADIX
+#define DCT_PLAN_MAX_RADIX 13
+#endif
+
+/** Largest length that is transformed with the cosine matrix (O(n^2)) */
+#ifndef DCT_PLAN_DIRECT_MAX
+#define DCT_PLAN_DIRECT_MAX 128
+#endif
+
+#define DCT_PLAN_PI 3.14159265358979323846
+
+/** a * b without the special cases of std::complex (i.e. __muldc3) */
+template <typename T>
+inline std::complex<T>
+CMul(const std::complex<T>& a, const std::complex<T>& b)
+{
+  return std::complex<T>(a.real()*b.real() - a.imag()*b.imag(), a.real()*b.imag() + a.imag()*b.real());
+}
+
+/**
+ * Mixed-radix complex FFT (unnormalized in both directions).
+ */
+template <typename T>
+class FftRadixPlan
+{
+public:
+  typedef std::complex<T> C;
+
+  FftRadixPlan() : n(0) {}
+
+  explicit FftRadixPlan(int _n) : n(_n), twiddles(_n)
+  {
+    for (int k = 0; k < n; k++)
+      twiddles[k] = std::polar(T(1), T(-2 * DCT_PLAN_PI * double(k) / double(n)));
+    // factors in the order 4, 2, 3, 5, 7, ... (p_1, m_1, p_2, m_2, ..., with m_i = m_{i+1} p_{i+1})
+    int p = 4;
+    int m = n;
+    const int floor_sqrt = int(std::floor(std::sqrt(double(n))));
+    while (m > 1)
+    {
+      while (m % p)
+      {
+        switch (p)
+        {
+          case 4: p = 2; break;
+          case 2: p = 3; break;
+          default: p += 2; break;
+        }
+        if (p > floor_sqrt)
+          p = m;
+      }
+      m /= p;
+      factors.push_back(p);
+      factors.push_back(m);
+    }
+  }
+
+  /** largest radix of the decomposition */
+  int
+  max_radix() const
+  {
+    int p = 1;
+    for (size_t i = 0; i < factors.size(); i += 2)
+      if (factors[i] > p)
+        p = factors[i];
+    return p;
+  }
+
+  /** out = DFT(in), or the unnormalized inverse DFT */
+  void
+  execute(const C* in, C* out, bool inverse, C* scratch) const
+  {
+    if (n == 1)
+      out[0] = in[0];
+    else
+      work(out, in, 1, &factors[0], inverse, scratch);
+  }
+
+private:
+  void
+  work(C* out, const C* in, int fstride, const int* factor, bool inverse, C* scratch) const
+  {
+    const int p = factor[0];
+    const int m = factor[1];
+    C* out_begin = out;
+    C* out_end = out + p*m;
+    if (m == 1)
+    {
+      do { *out = *in; in += fstride; } while (++out != out_end);
+    }
+    else
+    {
+      do { work(out, in, fstride*p, factor + 2, inverse, scratch); in += fstride; } while ((out += m) != out_end);
+    }
+    out = out_begin;
+    switch (p)
+    {
+      case 2:  butterfly2(out, fstride, m, inverse); break;
+      case 4:  butterfly4(out, fstride, m, inverse); break;
+      default: butterfly(out, fstride, p, m, inverse, scratch); break;
+    }
+  }
+
+  C
+  twiddle(int k, bool inverse) const
+  {
+    return (inverse ? std::conj(twiddles[k]) : twiddles[k]);
+  }
+
+  void
+  butterfly2(C* out, int fstride, int m, bool inverse) const
+  {
+    for (int u = 0; u < m; u++)
+    {
+      const C t = CMul(out[u + m], twiddle(u*fstride, inverse));
+      out[u + m] = out[u] - t;
+      out[u] += t;
+    }
+  }
+
+  void
+  butterfly4(C* out, int fstride, int m, bool inverse) const
+  {
+    for (int u = 0; u < m; u++)
+    {
+      const C s0 = CMul(out[u + m], twiddle(u*fstride, inverse));
+      const C s1 = CMul(out[u + 2*m], twiddle(2*u*fstride, inverse));
+      const C s2 = CMul(out[u + 3*m], twiddle(3*u*fstride, inverse));
+      const C s5 = out[u] - s1;
+      out[u] += s1;
+      const C s3 = s0 + s2;
+      const C s4 = s0 - s2;
+      out[u + 2*m] = out[u] - s3;
+      out[u] += s3;
+      if (inverse)
+      {
+        out[u + m]   = C(s5.real() - s4.imag(), s5.imag() + s4.real());
+        out[u + 3*m] = C(s5.real() + s4.imag(), s5.imag() - s4.real());
+      }
+      else
+      {
+        out[u + m]   = C(s5.real() + s4.imag(), s5.imag() - s4.real());
+        out[u + 3*m] = C(s5.real() - s4.imag(), s5.imag() + s4.real());
+      }
+    }
+  }
+
+  /** generic radix-p butterfly, O(p^2) per group of p outputs */
+  void
+  butterfly(C* out, int fstride, int p, int m, bool inverse, C* scratch) const
+  {
+    for (int u = 0; u < m; u++)
+    {
+      for (int q = 0; q < p; q++)
+        scratch[q] = out[u + q*m];
+      for (int q = 0; q < p; q++)
+      {
+        const int k = u + q*m;
+        const int step = (fstride*k) % n;
+        int t = 0;
+        C acc = scratch[0];
+        for (int r = 1; r < p; r++)
+        {
+          t += step;
+          if (t >= n)
+            t -= n;
+          acc += CMul(scratch[r], twiddle(t, inverse));
+        }
+        out[k] = acc;
+      }
+    }
+  }
+
+  int n;
+  std::vector<C> twiddles; // exp(-2 pi i k / n)
+  std::vector<int> factors;
+};
+
+/**
+ * Complex FFT of arbitrary length: mixed-radix, or Bluestein's algorithm for
+ * lengths with large prime factors.
+ */
+template <typename T>
+class FftPlan
+{
+public:
+  typedef std::complex<T> C;
+
+  FftPlan() : n(0), m(0) {}
+
+  explicit FftPlan(int _n) : n(_n), m(0), radix(_n)
+  {
+    if (radix.max_radix() <= DCT_PLAN_MAX_RADIX)
+      return;
+    // Bluestein: X_k = c_k sum_j (x_j c_j) conj(c_{k-j}), c_j = exp(-pi i j^2 / n),
+    // i.e. a circular convolution of length m >= 2n-1 (a power of two)
+    m = 1;
+    while (m < 2*n - 1)
+      m *= 2;
+    radix = FftRadixPlan<T>(m);
+    chirp.resize(n);
+    for (int j = 0; j < n; j++)
+    {
+      const long long jj = ((long long)j * j) % (2LL * n); // keep the argument small
+      chirp[j] = std::polar(T(1), T(-DCT_PLAN_PI * double(jj) / double(n)));
+    }
+    std::vector<C> kernel(m, C(0));
+    kernel[0] = std::conj(chirp[0]);
+    for (int j = 1; j < n; j++)
+      kernel[j] = kernel[m - j] = std::conj(chirp[j]);
+    kernel_fft.resize(m);
+    std::vector<C> scratch(scratch_size());
+    radix.execute(&kernel[0], &kernel_fft[0], false, &scratch[0]);
+  }
+
+  /** number of complex elements that execute needs as workspace */
+  int
+  scratch_size() const
+  {
+    return (m > 0 ? 2*m + 4 : n);
+  }
+
+  /** out = DFT(in), or the unnormalized inverse DFT; in and out must not overlap */
+  void
+  execute(const C* in, C* out, bool inverse, C* scratch) const
+  {
+    if (m == 0)
+    {
+      radix.execute(in, out, inverse, scratch);
+      return;
+    }
+    // the inverse DFT is conj(DFT(conj(x)))
+    C* a = scratch;
+    C* b = scratch + m;
+    for (int j = 0; j < n; j++)
+      a[j] = CMul(inverse ? std::conj(in[j]) : in[j], chirp[j]);
+    for (int j = n; j < m; j++)
+      a[j] = C(0);
+    radix.execute(a, b, false, b + m); // radix 4 and 2 only, i.e. no scratch
+    for (int j = 0; j < m; j++)
+      b[j] = CMul(b[j], kernel_fft[j]);
+    radix.execute(b, a, true, b + m);
+    const T scale = T(1) / T(m);
+    for (int k = 0; k < n; k++)
+    {
+      const C x = CMul(a[k], chirp[k]) * scale;
+      out[k] = (inverse ? std::conj(x) : x);
+    }
+  }
+
+private:
+  int n;
+  int m; // Bluestein convolution length (0: plain mixed-radix FFT)
+  FftRadixPlan<T> radix;
+  std::vector<C> chirp;
+  std::vector<C> kernel_fft;
+};
+
+/**
+ * Type-II and type-III DCT of a fixed length n.
+ */
+template <typename T>
+class DctPlan
+{
+public:
+  typedef std::complex<T> C;
+  typedef void (*Codelet)(const T*, T*, int, int, int, int, int);
+
+  DctPlan() : n(0), codelet_type2(0), codelet_type3(0) {}
+
+  /** use_codelets=false plans every length with Makhoul's FFT (e.g. to compare with the codelets) */
+  explicit DctPlan(int _n, bool use_codelets = true) : n(_n), codelet_type2(0), codelet_type3(0)
+  {
+    if (use_codelets && n == 48)
+    {
+      codelet_type2 = &dct_type2_48_simd<T>;
+      codelet_type3 = &dct_type3_48_simd<T>;
+      return;
+    }
+    if (use_codelets && n == 64)
+    {
+      codelet_type2 = &dct_type2_64_simd<T>;
+      codelet_type3 = &dct_type3_64_simd<T>;
+      return;
+    }
+    if (use_codelets && n <= DCT_PLAN_DIRECT_MAX)
+    {
+      // X = matrix2 x and y = matrix3 X (the FFTW conventions, see above)
+      matrix2.resize(n*n);
+      matrix3.resize(n*n);
+      for (int k = 0; k < n; k++)
+        for (int j = 0; j < n; j++)
+        {
+          const T c = T(2 * std::cos(DCT_PLAN_PI * double(k) * double(2*j + 1) / double(2*n)));
+          matrix2[k*n + j] = c;
+          matrix3[j*n + k] = (k == 0 ? T(1) : c);
+        }
+      return;
+    }
+    fft = FftPlan<T>(n);
+    shift.resize(n);
+    for (int k = 0; k < n; k++)
+      shift[k] = std::polar(T(1), T(-DCT_PLAN_PI * double(k) / double(2*n))); // exp(-pi i k / (2n))
+  }
+
+  int size() const { return n; }
+
+  /** number of complex elements that type2 and type3 need as workspace */
+  int scratch_size() const { return (matrix2.empty() ? 2*n + fft.scratch_size() : n*DIRECT_BLOCK); }
+
+  /**
+   * v type-II DCTs (see the implementation notes for strides and normalization);
+   * scratch (scratch_size() elements) is allocated if it is not given.
+   */
+  void
+  type2(const T* I, T* O, int is, int os, int v, int ivs, int ovs, bool do_normalization = false, C* scratch = 0) const
+  {
+    if (codelet_type2)
+    {
+      codelet_type2(I, O, is, os, v, ivs, ovs);
+    }
+    else if (!matrix2.empty())
+    {
+      std::vector<C> work;
+      if (!scratch)
+      {
+        work.resize(scratch_size());
+        scratch = &work[0];
+      }
+      direct(&matrix2[0], I, O, is, os, v, ivs, ovs, (T*)scratch);
+    }
+    else
+    {
+      std::vector<C> work;
+      if (!scratch)
+      {
+        work.resize(scratch_size());
+        scratch = &work[0];
+      }
+      C* a = scratch;
+      C* b = a + n;
+      for (int l = 0; l < v; l++)
+      {
+        const T* in = I + l*ivs;
+        T* out = O + l*ovs;
+        // Makhoul: even samples in order, odd samples reversed, ...
+        for (int k = 0; 2*k < n; k++)
+          a[k] = C(in[2*k*is], 0);
+        for (int k = 0; 2*k + 1 < n; k++)
+          a[n - 1 - k] = C(in[(2*k + 1)*is], 0);
+        fft.execute(a, b, false, b + n);
+        // ... and X_k = 2 Re(exp(-pi i k / (2n)) V_k)
+        for (int k = 0; k < n; k++)
+          out[k*os] = 2 * (shift[k].real()*b[k].real() - shift[k].imag()*b[k].imag());
+      }
+    }
+    if (do_normalization)
+    {
+      const T s0 = std::sqrt(T(1) / T(4*n));
+      const T s = std::sqrt(T(1) / T(2*n));
+      for (int l = 0; l < v; l++)
+      {
+        T* out = O + l*ovs;
+        out[0] *= s0;
+        for (int k = 1; k < n; k++)
+          out[k*os] *= s;
+      }
+    }
+  }
+
+  /** v type-III DCTs, i.e. inverse type-II DCTs (up to the factor 2n without normalization) */
+  void
+  type3(const T* I, T* O, int is, int os, int v, int ivs, int ovs, bool do_normalization = false, C* scratch = 0) const
+  {
+    if (codelet_type3)
+    {
+      codelet_type3(I, O, is, os, v, ivs, ovs);
+    }
+    else if (!matrix3.empty())
+    {
+      std::vector<C> work;
+      if (!scratch)
+      {
+        work.resize(scratch_size());
+        scratch = &work[0];
+      }
+      direct(&matrix3[0], I, O, is, os, v, ivs, ovs, (T*)scratch);
+    }
+    else
+    {
+      std::vector<C> work;
+      if (!scratch)
+      {
+        work.resize(scratch_size());
+        scratch = &work[0];
+      }
+      C* a = scratch;
+      C* b = a + n;
+      for (int l = 0; l < v; l++)
+      {
+        const T* in = I + l*ivs;
+        T* out = O + l*ovs;
+        // V_k = exp(pi i k / (2n)) (X_k - i X_{n-k}), V_0 = X_0 ...
+        a[0] = C(in[0], 0);
+        for (int k = 1; k < n; k++)
+          a[k] = CMul(std::conj(shift[k]), C(in[k*is], -in[(n - k)*is]));
+        fft.execute(a, b, true, b + n);
+        // ... and undo Makhoul's permutation
+        for (int k = 0; 2*k < n; k++)
+          out[2*k*os] = b[k].real();
+        for (int k = 0; 2*k + 1 < n; k++)
+          out[(2*k + 1)*os] = b[n - 1 - k].real();
+      }
+    }
+    if (do_normalization)
+    {
+      // scaling X_0 by s0 and X_k by s adds (s0 - s) X_0 to every output
+      const T s0 = std::sqrt(T(1) / T(n));
+      const T s = std::sqrt(T(1) / T(2*n));
+      for (int l = 0; l < v; l++)
+      {
+        const T d = (s0 - s) * I[l*ivs];
+        T* out = O + l*ovs;
+        for (int k = 0; k < n; k++)
+          out[k*os] = s * out[k*os] + d;
+      }
+    }
+  }
+
+private:
+  /** Number of transforms of one block of direct (an L1 tile) */
+  enum { DIRECT_BLOCK = 16 };
+
+  /**
+   * y = A x for the n x n (row-major) matrix A and B arrays at a time: x and
+   * y hold element j of array l at j*xs + l (y: j*B + l), i.e. the arrays
+   * are the inner, vectorized loop.
+   */
+  template <int B>
+  void
+  direct_block(const T* A, const T* x, int xs, T* y) const
+  {
+    for (int k = 0; k < n; k++)
+    {
+      const T* a = A + k*n;
+      T acc[B];
+      for (int l = 0; l < B; l++)
+        acc[l] = 0;
+      for (int j = 0; j < n; j++)
+      {
+        const T c = a[j];
+        const T* x_j = x + j*xs;
+        // (else GCC vectorizes the loop over j instead)
+#pragma omp simd
+        for (int l = 0; l < B; l++)
+          acc[l] += c * x_j[l];
+      }
+      for (int l = 0; l < B; l++)
+        y[k*B + l] = acc[l];
+    }
+  }
+
+  /** y = A x for one array (four rows of A at a time) */
+  void
+  direct_single(const T* A, const T* x, T* y) const
+  {
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+      const T* a = A + k*n;
+      T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+      for (int j = 0; j < n; j++)
+      {
+        s0 += a[j] * x[j];
+        s1 += a[n + j] * x[j];
+        s2 += a[2*n + j] * x[j];
+        s3 += a[3*n + j] * x[j];
+      }
+      y[k] = s0; y[k + 1] = s1; y[k + 2] = s2; y[k + 3] = s3;
+    }
+    for (; k < n; k++)
+    {
+      T s = 0;
+      for (int j = 0; j < n; j++)
+        s += A[k*n + j] * x[j];
+      y[k] = s;
+    }
+  }
+
+  /**
+   * O_l = A I_l for the n x n (row-major) matrix A: DIRECT_BLOCK arrays at a
+   * time (read in place if they are adjacent, else gathered into a tile, the
+   * last ones padded with zeros), and fewer than 4 arrays one by one. Each
+   * block is read completely before it is written, i.e. I and O may be the
+   * same. work has 2 n DIRECT_BLOCK elements.
+   */
+  void
+  direct(const T* A, const T* I, T* O, int is, int os, int v, int ivs, int ovs, T* work) const
+  {
+    const int B = DIRECT_BLOCK;
+    T* x = work;
+    T* y = work + n*B;
+    for (int l0 = 0; l0 < v; l0 += B)
+    {
+      const int b = std::min(B, v - l0);
+      const T* in = I + l0*ivs;
+      T* out = O + l0*ovs;
+      if (b < 4)
+      {
+        for (int l = 0; l < b; l++)
+        {
+          for (int j = 0; j < n; j++)
+            x[j] = in[l*ivs + j*is];
+          direct_single(A, x, y);
+          for (int k = 0; k < n; k++)
+            out[l*ovs + k*os] = y[k];
+        }
+        continue;
+      }
+      if (b == B && ivs == 1)
+      {
+        direct_block<B>(A, in, is, y);
+      }
+      else
+      {
+        for (int l = 0; l < b; l++)
+          for (int j = 0; j < n; j++)
+            x[j*B + l] = in[l*ivs + j*is];
+        for (int l = b; l < B; l++)
+          for (int j = 0; j < n; j++)
+            x[j*B + l] = 0;
+        direct_block<B>(A, x, B, y);
+      }
+      if (ovs == 1)
+      {
+        for (int k = 0; k < n; k++)
+          for (int l = 0; l < b; l++)
+            out[k*os + l] = y[k*B + l];
+      }
+      else
+      {
+        for (int l = 0; l < b; l++)
+          for (int k = 0; k < n; k++)
+            out[l*ovs + k*os] = y[k*B + l];
+      }
+    }
+  }
+
+  int n;
+  Codelet codelet_type2;
+  Codelet codelet_type3;
+  FftPlan<T> fft;
+  std::vector<C> shift; // exp(-pi i k / (2n))
+  std::vector<T> matrix2; // 2 cos(pi k (2j+1) / (2n)) at (k, j), for n <= DCT_PLAN_DIRECT_MAX
+  std::vector<T> matrix3; // its transpose with the column k = 0 halved (type-III)
+};
+
+/**
+ * The (cached) plan for length n. Plans are built on first use and live as
+ * long as the program (or .mex-file) is loaded; any thread (OpenMP or not)
+ * may look them up.
+ */
+template <typename T>
+const DctPlan<T>&
+GetDctPlan(int n)
+{
+  static std::map<int, DctPlan<T> > plans;
+  static std::mutex plans_mutex;
+  std::lock_guard<std::mutex> lock(plans_mutex);
+  typename std::map<int, DctPlan<T> >::iterator it = plans.find(n);
+  if (it == plans.end())
+    it = plans.insert(std::make_pair(n, DctPlan<T>(n))).first;
+  return it->second;
+}
+
+/** Number of arrays per call of the batched DCTs */
+#ifndef DCT_PLAN_BATCH_BLOCK
+#define DCT_PLAN_BATCH_BLOCK 64
+#endif
+
+/**
+ * Number of matrices with N columns that dct2_type2_batch transforms per
+ * chunk, i.e. its temporary data has M*N*DctBatchChunk(N) elements.
+ */
+inline int
+DctBatchChunk(int N)
+{
+  return (N < DCT_PLAN_BATCH_BLOCK ? DCT_PLAN_BATCH_BLOCK / N : 1);
+}
+
+/**
+ * 2-D type-II DCT of K MxN (column-major) matrices that are stored one after
+ * another; indata and outdata may be the same. The columns of a chunk of
+ * DctBatchChunk(N) matrices are transformed through one (strided) call;
+ * matrices with 48 or 64 rows and columns use the blocked dct2_type2_simd.
+ * tmpdata (M*N*DctBatchChunk(N) elements) and scratch (for the plans of M and
+ * N) are the caller's workspace. Each matrix gets the result of dct2_type2.
+ */
+template <typename T>
+void
+dct2_type2_batch(const T* indata, T* outdata, int M, int N, int K, bool do_normalization,
+                 T* tmpdata, std::complex<T>* scratch)
+{
+  const DctPlan<T>& plan_M = GetDctPlan<T>(M);
+  const DctPlan<T>& plan_N = GetDctPlan<T>(N);
+  const size_t MN = (size_t)M*N;
+  const int chunk = DctBatchChunk(N);
+  int first = 0;
+  // 48 and 64: the blocked 2-D DCT of the vectorized codelets (if available)
+  while (first < K && dct2_type2_simd(indata + first*MN, outdata + first*MN, M, N, do_normalization, tmpdata))
+    first++;
+  for (; first < K; first += chunk)
+  {
+    const int count = (K - first < chunk ? K - first : chunk);
+    // each row of each matrix (the order of dct2_type2_48_64), ...
+    for (int i = 0; i < count; i++)
+      plan_N.type2(indata + (first + i)*MN, tmpdata + i*MN, M, M, M, 1, 1, do_normalization, scratch);
+    // ... then the columns of all matrices
+    plan_M.type2(tmpdata, outdata + first*MN, 1, 1, count*N, M, M, do_normalization, scratch);
+  }
+}
+
+/** Inverse of dct2_type2_batch (each matrix gets the result of idct2_type2) */
+template <typename T>
+void
+idct2_type2_batch(const T* indata, T* outdata, int M, int N, int K, bool do_normalization,
+                  T* tmpdata, std::complex<T>* scratch)
+{
+  const DctPlan<T>& plan_M = GetDctPlan<T>(M);
+  const DctPlan<T>& plan_N = GetDctPlan<T>(N);
+  const size_t MN = (size_t)M*N;
+  const int chunk = DctBatchChunk(N);
+  int first = 0;
+  while (first < K && idct2_type2_simd(indata + first*MN, outdata + first*MN, M, N, do_normalization, tmpdata))
+    first++;
+  for (; first < K; first += chunk)
+  {
+    const int count = (K - first < chunk ? K - first : chunk);
+    // the columns of all matrices (the order of idct2_type2_48_64), ...
+    plan_M.type3(indata + first*MN, tmpdata, 1, 1, count*N, M, M, do_normalization, scratch);
+    // ... then each row of each matrix
+    for (int i = 0; i < count; i++)
+      plan_N.type3(tmpdata + i*MN, outdata + (first + i)*MN, M, M, M, 1, 1, do_normalization, scratch);
+  }
+}
+
+/** 2-D type-II DCT of an MxN (column-major) matrix */
+template <typename T>
+void
+dct2_type2(const T* indata, T* outdata, int M, int N, bool do_normalization = true)
+{
+  std::vector<T> tmpdata(M*N);
+  std::vector<std::complex<T> > scratch(std::max(GetDctPlan<T>(M).scratch_size(), GetDctPlan<T>(N).scratch_size()));
+  dct2_type2_batch(indata, outdata, M, N, 1, do_normalization, &tmpdata[0], &scratch[0]);
+}
+
+/** Inverse of the 2-D type-II DCT of an MxN (column-major) matrix */
+template <typename T>
+void
+idct2_type2(const T* indata, T* outdata, int M, int N, bool do_normalization = true)
+{
+  std::vector<T> tmpdata(M*N);
+  std::vector<std::complex<T> > scratch(std::max(GetDctPlan<T>(M).scratch_size(), GetDctPlan<T>(N).scratch_size()));
+  idct2_type2_batch(indata, outdata, M, N, 1, do_normalization, &tmpdata[0], &scratch[0]);
+}
@@ -0,0 +1,263 @@
+/**
+ * Vectorized ("v-parallel") DCT codelets, see dct_simd.hpp.
+ *
+ * The generated codelets (dct_type2_48.cpp, ...) are included once per
+ * instruction set (dct_simd_codelets.inc) with a vector type for R and
+ * fused multiply-adds for their FMA macros.
+ */
+#include <cmath>
+#include <cstddef>
+
+#include "quaternion_simd.hpp" // the instruction set of this CPU (and the intrinsics)
+
+#if !defined(DCT_SIMD_DISABLE) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(QUATERNION_SIMD_X86_AVX) || defined(QUATERNION_SIMD_NEON))
+#define DCT_SIMD
+#endif
+
+#ifdef DCT_SIMD
+// the codelets compute with these instead of ((a) * (b)) + (c), ...
+#define FMA(a, b, c) DctFma(a, b, c)
+#define FMS(a, b, c) DctFms(a, b, c)
+#define FNMS(a, b, c) DctFnms(a, b, c)
+#define DCT_CODELETS_NO_INSTANTIATION
+#endif
+
+#include "dct_type2.hpp"
+#include "dct_simd.hpp"
+
+#if defined(DCT_SIMD) && defined(QUATERNION_SIMD_X86_AVX)
+
+#ifdef __clang__
+#pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace dct_simd_avx2
+{
+  template <typename T> struct Vec;
+
+  template <>
+  struct Vec<float>
+  {
+    typedef float T;
+    typedef __m256 R __attribute__((aligned(4)));
+    enum { W = 8 };
+    static inline R set1(T x) { return _mm256_set1_ps(x); }
+    static inline R fmadd(R a, R b, R c) { return _mm256_fmadd_ps(a, b, c); }
+    static inline R fmsub(R a, R b, R c) { return _mm256_fmsub_ps(a, b, c); }
+    static inline R fnmadd(R a, R b, R c) { return _mm256_fnmadd_ps(a, b, c); }
+  };
+
+  template <>
+  struct Vec<double>
+  {
+    typedef double T;
+    typedef __m256d R __attribute__((aligned(8)));
+    enum { W = 4 };
+    static inline R set1(T x) { return _mm256_set1_pd(x); }
+    static inline R fmadd(R a, R b, R c) { return _mm256_fmadd_pd(a, b, c); }
+    static inline R fmsub(R a, R b, R c) { return _mm256_fmsub_pd(a, b, c); }
+    static inline R fnmadd(R a, R b, R c) { return _mm256_fnmadd_pd(a, b, c); }
+  };
+
+#include "dct_simd_codelets.inc"
+}
+
+#ifdef __clang__
+#pragma clang attribute pop
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+namespace dct_simd_avx512
+{
+  template <typename T> struct Vec;
+
+  template <>
+  struct Vec<float>
+  {
+    typedef float T;
+    typedef __m512 R __attribute__((aligned(4)));
+    enum { W = 16 };
+    static inline R set1(T x) { return _mm512_set1_ps(x); }
+    static inline R fmadd(R a, R b, R c) { return _mm512_fmadd_ps(a, b, c); }
+    static inline R fmsub(R a, R b, R c) { return _mm512_fmsub_ps(a, b, c); }
+    static inline R fnmadd(R a, R b, R c) { return _mm512_fnmadd_ps(a, b, c); }
+  };
+
+  template <>
+  struct Vec<double>
+  {
+    typedef double T;
+    typedef __m512d R __attribute__((aligned(8)));
+    enum { W = 8 };
+    static inline R set1(T x) { return _mm512_set1_pd(x); }
+    static inline R fmadd(R a, R b, R c) { return _mm512_fmadd_pd(a, b, c); }
+    static inline R fmsub(R a, R b, R c) { return _mm512_fmsub_pd(a, b, c); }
+    static inline R fnmadd(R a, R b, R c) { return _mm512_fnmadd_pd(a, b, c); }
+  };
+
+#include "dct_simd_codelets.inc"
+}
+
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#elif defined(DCT_SIMD) && defined(QUATERNION_SIMD_NEON)
+
+namespace dct_simd_neon
+{
+  template <typename T> struct Vec;
+
+  template <>
+  struct Vec<float>
+  {
+    typedef float T;
+    typedef float32x4_t R __attribute__((aligned(4)));
+    enum { W = 4 };
+    static inline R set1(T x) { return vdupq_n_f32(x); }
+    static inline R fmadd(R a, R b, R c) { return vfmaq_f32(c, a, b); }
+    static inline R fmsub(R a, R b, R c) { return vnegq_f32(vfmsq_f32(c, a, b)); }
+    static inline R fnmadd(R a, R b, R c) { return vfmsq_f32(c, a, b); }
+  };
+
+  template <>
+  struct Vec<double>
+  {
+    typedef double T;
+    typedef float64x2_t R __attribute__((aligned(8)));
+    enum { W = 2 };
+    static inline R set1(T x) { return vdupq_n_f64(x); }
+    static inline R fmadd(R a, R b, R c) { return vfmaq_f64(c, a, b); }
+    static inline R fmsub(R a, R b, R c) { return vnegq_f64(vfmsq_f64(c, a, b)); }
+    static inline R fnmadd(R a, R b, R c) { return vfmsq_f64(c, a, b); }
+  };
+
+#include "dct_simd_codelets.inc"
+}
+
+#endif
+
+#if defined(DCT_SIMD) && defined(QUATERNION_SIMD_X86_AVX)
+#define DCT_SIMD_DISPATCH(call) \
+  switch (GetQuaternionSimdLevel()) \
+  { \
+    case QUATERNION_SIMD_AVX512: return dct_simd_avx512::call; \
+    case QUATERNION_SIMD_AVX2: return dct_simd_avx2::call; \
+    default: break; \
+  }
+#define DCT_SIMD_WIDTH(R) \
+  (GetQuaternionSimdLevel() == QUATERNION_SIMD_AVX512 ? (int)dct_simd_avx512::Vec<R>::W : \
+   GetQuaternionSimdLevel() == QUATERNION_SIMD_AVX2 ? (int)dct_simd_avx2::Vec<R>::W : 1)
+#elif defined(DCT_SIMD) && defined(QUATERNION_SIMD_NEON)
+#define DCT_SIMD_DISPATCH(call) return dct_simd_neon::call;
+#define DCT_SIMD_WIDTH(R) ((int)dct_simd_neon::Vec<R>::W)
+#else
+#define DCT_SIMD_DISPATCH(call)
+#define DCT_SIMD_WIDTH(R) 1
+#endif
+
+template <typename R>
+int
+dct_simd_width()
+{
+  return DCT_SIMD_WIDTH(R);
+}
+
+template <typename R>
+void
+dct_type2_64_simd(const R * I, R * O, int is, int os, int v, int ivs, int ovs)
+{
+  DCT_SIMD_DISPATCH(dct_type2_64_simd(I, O, is, os, v, ivs, ovs))
+  dct_type2_64(I, O, is, os, v, ivs, ovs);
+}
+
+template <typename R>
+void
+dct_type2_48_simd(const R * I, R * O, int is, int os, int v, int ivs, int ovs)
+{
+  DCT_SIMD_DISPATCH(dct_type2_48_simd(I, O, is, os, v, ivs, ovs))
+  dct_type2_48(I, O, is, os, v, ivs, ovs);
+}
+
+template <typename R>
+void
+dct_type3_64_simd(const R * I, R * O, int is, int os, int v, int ivs, int ovs)
+{
+  DCT_SIMD_DISPATCH(dct_type3_64_simd(I, O, is, os, v, ivs, ovs))
+  dct_type3_64(I, O, is, os, v, ivs, ovs);
+}
+
+template <typename R>
+void
+dct_type3_48_simd(const R * I, R * O, int is, int os, int v, int ivs, int ovs)
+{
+  DCT_SIMD_DISPATCH(dct_type3_48_simd(I, O, is, os, v, ivs, ovs))
+  dct_type3_48(I, O, is, os, v, ivs, ovs);
+}
+
+/**
+ * The factors of the orthonormal type-II DCT of n elements (as Matlab's dct)
+ * for the outputs of the codelets, or of its inverse for the inputs of the
+ * type-III codelets (see DctPlan).
+ */
+template <typename R>
+static void
+DctNormalization(R* s, int n, bool inverse)
+{
+  s[0] = std::sqrt(R(1) / R(inverse ? n : 4*n));
+  for (int k = 1; k < n; k++)
+    s[k] = std::sqrt(R(1) / R(2*n));
+}
+
+template <typename R>
+bool
+dct2_type2_simd(const R * I, R * O, int M, int N, bool do_normalization, R * tmp)
+{
+  if ((M != 48 && M != 64) || (N != 48 && N != 64))
+    return false;
+  R s_M[64], s_N[64];
+  DctNormalization(s_M, M, false);
+  DctNormalization(s_N, N, false);
+  const R* s = (do_normalization ? s_M : 0);
+  DCT_SIMD_DISPATCH(dct2_type2_simd(I, O, M, N, s, s_N, tmp))
+  return false;
+}
+
+template <typename R>
+bool
+idct2_type2_simd(const R * I, R * O, int M, int N, bool do_normalization, R * tmp)
+{
+  if ((M != 48 && M != 64) || (N != 48 && N != 64))
+    return false;
+  R s_M[64], s_N[64];
+  DctNormalization(s_M, M, true);
+  DctNormalization(s_N, N, true);
+  const R* s = (do_normalization ? s_M : 0);
+  DCT_SIMD_DISPATCH(idct2_type2_simd(I, O, M, N, s, s_N, tmp))
+  return false;
+}
+
+template int dct_simd_width<double>();
+template int dct_simd_width<float>();
+template void dct_type2_64_simd<>(const double*, double*, int, int, int, int, int);
+template void dct_type2_64_simd<>(const float*, float*, int, int, int, int, int);
+template void dct_type2_48_simd<>(const double*, double*, int, int, int, int, int);
+template void dct_type2_48_simd<>(const float*, float*, int, int, int, int, int);
+template void dct_type3_64_simd<>(const double*, double*, int, int, int, int, int);
+template void dct_type3_64_simd<>(const float*, float*, int, int, int, int, int);
+template void dct_type3_48_simd<>(const double*, double*, int, int, int, int, int);
+template void dct_type3_48_simd<>(const float*, float*, int, int, int, int, int);
+template bool dct2_type2_simd<>(const double*, double*, int, int, bool, double*);
+template bool dct2_type2_simd<>(const float*, float*, int, int, bool, float*);
+template bool idct2_type2_simd<>(const double*, double*, int, int, bool, double*);
+template bool idct2_type2_simd<>(const float*, float*, int, int, bool, float*);
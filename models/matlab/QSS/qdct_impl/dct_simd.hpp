@@ -0,0 +1,69 @@
+/**
+ * Vectorized ("v-parallel") versions of the 48 and 64 element DCT codelets
+ * of dct_type2.hpp, with the same interface and results.
+ *
+ * Implementation notes:
+ * --------------------
+ * - the codelets are compiled once more (dct_simd.cpp) with a SIMD vector
+ *   in place of the scalar type, i.e. each lane of a vector computes another
+ *   of the v transforms, W at a time (AVX-512F: 8 doubles or 16 floats,
+ *   AVX2+FMA: 4 or 8, NEON: 2 or 4), and the FMA/FMS/FNMS macros of the
+ *   codelets are fused multiply-adds of the instruction set
+ * - the instruction set is chosen at runtime (GetQuaternionSimdLevel of
+ *   quaternion_simd.hpp); the scalar codelets serve other CPUs, compilers
+ *   without the vector extensions of GCC/Clang, and DCT_SIMD_DISABLE (or
+ *   QUATERNION_SIMD_DISABLE)
+ * - adjacent arrays (ivs == ovs == 1, element strides that are multiples of
+ *   W, e.g. the rows of a column-major matrix) are transformed in place in
+ *   memory; other layouts (e.g. the columns) are gathered W arrays at a time
+ *   into a small buffer, and the last v % W arrays use the scalar codelets
+ * - dct2_type2_simd / idct2_type2_simd are blocked 2-D DCTs of 48/64 x 48/64
+ *   matrices: the strided pass (the rows) is vectorized over adjacent rows,
+ *   i.e. its loads and stores are contiguous, and the other pass runs on
+ *   tiles of W columns that stay in L1. The normalization is applied while
+ *   the tiles are stored (loaded for the inverse), not in passes of its own
+ * - dct_simd.cpp must be linked together with the scalar codelets
+ */
+#pragma once
+
+#include "dct_type2.hpp"
+
+/** Number of transforms that the vectorized codelets compute at once on this CPU (1: scalar) */
+template <typename R>
+int
+dct_simd_width();
+
+/** 1-D DCT type-II for 64 element arrays (vectorized dct_type2_64) */
+template <typename R>
+void
+dct_type2_64_simd(const R * I, R * O, int is, int os, int v, int ivs, int ovs);
+
+/** 1-D DCT type-II for 48 element arrays (vectorized dct_type2_48) */
+template <typename R>
+void
+dct_type2_48_simd(const R * I, R * O, int is, int os, int v, int ivs, int ovs);
+
+/** 1-D DCT type-III for 64 element arrays (vectorized dct_type3_64) */
+template <typename R>
+void
+dct_type3_64_simd(const R * I, R * O, int is, int os, int v, int ivs, int ovs);
+
+/** 1-D DCT type-III for 48 element arrays (vectorized dct_type3_48) */
+template <typename R>
+void
+dct_type3_48_simd(const R * I, R * O, int is, int os, int v, int ivs, int ovs);
+
+/**
+ * 2-D type-II DCT of a column-major M x N matrix for M, N in {48, 64}, as
+ * dct2_type2 of dct_plan.hpp (orthonormal with do_normalization); tmp has
+ * M*N elements, indata and outdata may be the same. Returns false (and
+ * leaves outdata untouched) for other sizes or without vectorized codelets.
+ */
+template <typename R>
+bool
+dct2_type2_simd(const R * indata, R * outdata, int M, int N, bool do_normalization, R * tmp);
+
+/** Inverse of dct2_type2_simd (as idct2_type2 of dct_plan.hpp) */
+template <typename R>
+bool
+idct2_type2_simd(const R * indata, R * outdata, int M, int N, bool do_normalization, R * tmp);
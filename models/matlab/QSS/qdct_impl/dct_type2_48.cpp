@@ -853,7 +853,9 @@ dct_type2_48(const R * I, R * O, stride is, stride os, INT v, INT ivs, INT ovs)
 }
 
 
+#ifndef DCT_CODELETS_NO_INSTANTIATION // (dct_simd.cpp instantiates them for its vector types)
 template void dct_type2_48<>(const double*, double*, int, int, int, int, int);
 template void dct_type2_48<>(const float*, float*, int, int, int, int, int);
 template void dct_type2_48<>(const double*, double*, size_t, size_t, size_t, size_t, size_t);
 template void dct_type2_48<>(const float*, float*, size_t, size_t, size_t, size_t, size_t);
+#endif
@@ -0,0 +1,143 @@
+/**
+ * Bicubic image resizing as Matlab's imresize(A,[m n],'bicubic').
+ *
+ * Implementation notes:
+ * --------------------
+ * - Keys' cubic kernel (a = -0.5) with antialiasing when shrinking, i.e. the
+ *   kernel is stretched by 1/scale along a dimension with scale < 1
+ * - the borders are extended symmetrically and the weights of each output
+ *   pixel are normalized to sum to one (as imresize's contributions)
+ * - the dimension with the smaller scale is resized first (as imresize)
+ * - matrices are column-major (Matlab), one channel at a time
+ */
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+/**
+ * The weights and (0-based) input indices of each output element of a 1-D
+ * resize from in_length to out_length elements.
+ */
+class ImresizeContributions
+{
+public:
+  ImresizeContributions(int in_length, int out_length)
+  {
+    const double scale = double(out_length) / double(in_length);
+    const bool antialiasing = (scale < 1);
+    const double kernel_width = (antialiasing ? 4 / scale : 4);
+    P = int(std::ceil(kernel_width)) + 2;
+    weights.resize(out_length*P);
+    indices.resize(out_length*P);
+    for (int x = 0; x < out_length; x++)
+    {
+      // 1-based coordinates, as in imresize
+      const double u = (x + 1) / scale + 0.5 * (1 - 1 / scale);
+      const int left = int(std::floor(u - kernel_width / 2));
+      double sum = 0;
+      for (int p = 0; p < P; p++)
+      {
+        const double d = u - (left + p);
+        const double w = (antialiasing ? scale * Cubic(scale * d) : Cubic(d));
+        weights[x*P + p] = w;
+        sum += w;
+        // symmetric extension of the border: [1:in_length, in_length:-1:1]
+        int i = (left + p - 1) % (2*in_length);
+        if (i < 0)
+          i += 2*in_length;
+        indices[x*P + p] = (i < in_length ? i : 2*in_length - 1 - i);
+      }
+      for (int p = 0; p < P; p++)
+        weights[x*P + p] /= sum;
+    }
+  }
+
+  int P;                       // number of weights per output element
+  std::vector<double> weights; // out_length x P
+  std::vector<int> indices;    // out_length x P
+
+private:
+  static double
+  Cubic(double x)
+  {
+    const double absx = std::fabs(x);
+    const double absx2 = absx*absx;
+    const double absx3 = absx2*absx;
+    if (absx <= 1)
+      return 1.5*absx3 - 2.5*absx2 + 1;
+    if (absx <= 2)
+      return -0.5*absx3 + 2.5*absx2 - 4*absx + 2;
+    return 0;
+  }
+};
+
+/** Resize each column of the MxN matrix A to m elements (B is mxN). */
+template <typename T>
+void
+ImresizeColumns(const T* A, T* B, int M, int N, int m)
+{
+  const ImresizeContributions c(M, m);
+  for (int x = 0; x < N; x++)
+  {
+    const T* a = A + x*M;
+    T* b = B + x*m;
+    for (int y = 0; y < m; y++)
+    {
+      double v = 0;
+      for (int p = 0; p < c.P; p++)
+        v += c.weights[y*c.P + p] * a[c.indices[y*c.P + p]];
+      b[y] = T(v);
+    }
+  }
+}
+
+/** Resize each row of the MxN matrix A to n elements (B is Mxn). */
+template <typename T>
+void
+ImresizeRows(const T* A, T* B, int M, int N, int n)
+{
+  const ImresizeContributions c(N, n);
+  for (int x = 0; x < n; x++)
+  {
+    T* b = B + x*M;
+    for (int y = 0; y < M; y++)
+      b[y] = 0;
+    for (int p = 0; p < c.P; p++)
+    {
+      const double w = c.weights[x*c.P + p];
+      if (w == 0)
+        continue;
+      const T* a = A + c.indices[x*c.P + p]*M;
+      for (int y = 0; y < M; y++)
+        b[y] += T(w * a[y]);
+    }
+  }
+}
+
+/** Resize the MxN matrix A to the mxn matrix B (bicubic, as imresize). */
+template <typename T>
+void
+ImresizeBicubic(const T* A, T* B, int M, int N, int m, int n)
+{
+  if (m == M && n == N)
+  {
+    for (int i = 0; i < M*N; i++)
+      B[i] = A[i];
+    return;
+  }
+  const double scale_m = double(m) / double(M);
+  const double scale_n = double(n) / double(N);
+  if (scale_m <= scale_n)
+  {
+    std::vector<T> tmp(m*N);
+    ImresizeColumns(A, &tmp[0], M, N, m);
+    ImresizeRows(&tmp[0], B, m, N, n);
+  }
+  else
+  {
+    std::vector<T> tmp(M*n);
+    ImresizeRows(A, &tmp[0], M, N, n);
+    ImresizeColumns(&tmp[0], B, M, n, m);
+  }
+}
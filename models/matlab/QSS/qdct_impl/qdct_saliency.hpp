@@ -0,0 +1,164 @@
+/**
+ * If you use any of this work in scientific research or as part of a larger
+ * software system, you are kindly requested to cite the use in any related 
+ * publications or technical documentation. The work is based upon:
+ *
+ * [1] B. Schauerte, and R. Stiefelhagen, "Predicting Human Gaze using 
+ *     Quaternion DCT Image Signature Saliency and Face Detection," in IEEE 
+ *     Workshop on the Applications of Computer Vision (WACV), 2012.
+ * [2] B. Schauerte, and R. Stiefelhagen, "Quaternion-based Spectral 
+ *     Saliency Detection for Eye Fixation Prediction," in European 
+ *     Conference on Computer Vision (ECCV), 2012
+ */
+
+/** 
+ * The quaterion DCT-II saliency for MxN matrices of any size, i.e. the
+ * processing of qdct_saliency_48_64 with DCTs that are planned for the size
+ * of the input (dct_plan.hpp).
+ */
+#pragma once
+
+#include <cmath>
+#include <new>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "signum.hpp"           // the quaternion signum function
+#include "quaternion_simd.hpp"  // ... vectorized (signum and squared absolute value)
+#include "dct_plan.hpp"         // the type-II DCT and inverse DCT (planned for any size)
+#include "qdct_workspace.hpp"   // the reusable temporary data
+
+/**
+ * Norm of the (left-sided) axis products of the QDCT saliency, i.e. the real
+ * factor that remains of the two axis multiplications (see
+ * qdct_saliency_group): |axis|, whatever the direction of the axis and the
+ * order of its elements (the saliency does not depend on them).
+ */
+template <typename T>
+T
+qdct_saliency_axis_scale(const T* axis)
+{
+  return T(QUATERNION_ABS(axis[0],axis[1],axis[2],axis[3]));
+}
+
+/**
+ * Saliency (squared absolute value of the IQDCT of the QDCT signum) of K MxN
+ * images with 3 (pure quaternion) or 4 channels each, stored one after
+ * another, for the (left-sided) axis. With do_normalization, the DCTs are
+ * orthonormal (as qdct2 of the QTFM).
+ *
+ * The products with the axis are fused into the signum: the product with a
+ * constant quaternion is the same 4x4 real map at each pixel and commutes
+ * with the (channel-wise, real) DCTs, and quaternion norms multiply, i.e.
+ *   signum(DCT(mu*I)) = mu/|mu| signum(DCT(I))   and
+ *   |IDCT(mu*mu/|mu| S)|^2 = |mu|^2 |IDCT(S)|^2.
+ * Hence, the saliency is computed as the IQDCT of the scaled signum of the
+ * QDCT of the image itself (same result up to rounding), which leaves three
+ * passes over the data besides the DCTs (which read the image directly) and
+ * keeps pure quaternion images at 3 channels.
+ */
+template <typename T>
+void
+qdct_saliency_group(const T* axis, const T* indata, T* outdata, int M, int N, int num_image_channels, int K,
+                    bool do_normalization, QdctWorkspace<T>& workspace)
+{
+  const size_t MN = (size_t)M*N;
+  const int C = (num_image_channels == 3 ? 3 : 4);
+  const T scale = qdct_saliency_axis_scale(axis);
+  workspace.reserve(M, N, K);
+  T* q = workspace.quaternion;
+
+  ////
+  // Processing
+  // ==========
+  // 1   QDCT: dct for each of the C*K channels
+  dct2_type2_batch(indata, q, M, N, C*K, do_normalization, workspace.channel, workspace.scratch);
+  // 2.  SIGNUM (and the products with the axis)
+  for (int k = 0; k < K; k++)
+  {
+    if (C == 3)
+    {
+      ScaledSignumSimd_3c(q + k*MN*C,q + k*MN*C,scale,M,N);
+    }
+    else
+    {
+      ScaledSignumSimd_4c(q + k*MN*C,q + k*MN*C,scale,M,N);
+    }
+  }
+  // 3   IQDCT: idct for each of the C*K channels
+  idct2_type2_batch(q, q, M, N, C*K, do_normalization, workspace.channel, workspace.scratch);
+  // 4.  ABS
+  for (int k = 0; k < K; k++)
+  {
+    if (C == 3)
+    {
+      AbsSqrSimd_3c(q + k*MN*C,outdata + k*MN,M,N);
+    }
+    else
+    {
+      AbsSqrSimd_4c(q + k*MN*C,outdata + k*MN,M,N);
+    }
+  }
+}
+
+/**
+ * Saliency of an MxN image with 3 (pure quaternion) or 4 channels (see
+ * qdct_saliency_group), with the workspace of the calling thread.
+ */
+template <typename T>
+void
+qdct_saliency(const T* axis, const T* indata, T* outdata, int M, int N, int num_image_channels, bool do_normalization)
+{
+  qdct_saliency_group(axis, indata, outdata, M, N, num_image_channels, 1, do_normalization, GetQdctWorkspace<T>());
+}
+
+/** Working set (bytes) of one group of images of qdct_saliency_batch */
+#ifndef QDCT_SALIENCY_BATCH_BYTES
+#define QDCT_SALIENCY_BATCH_BYTES (1 << 20)
+#endif
+
+/**
+ * Saliency of K MxN images with 3 or 4 channels each (stored one after another,
+ * e.g. the frames of a video), with the same result as qdct_saliency for each
+ * image. The images are processed in groups whose quaternion data fit into
+ * QDCT_SALIENCY_BATCH_BYTES (qdct_saliency_group); with OpenMP, the groups
+ * run in parallel, each thread with its own workspace.
+ */
+template <typename T>
+void
+qdct_saliency_batch(const T* axis, const T* indata, T* outdata, int M, int N, int num_image_channels, int K, bool do_normalization)
+{
+  const size_t MN = (size_t)M*N;
+  const size_t image_bytes = 4*MN*sizeof(T);
+  int group = (image_bytes < QDCT_SALIENCY_BATCH_BYTES ? int(QDCT_SALIENCY_BATCH_BYTES / image_bytes) : 1);
+#ifdef _OPENMP
+  // at least one group per thread
+  const int threads = omp_get_max_threads();
+  if (group > (K + threads - 1) / threads)
+    group = (K + threads - 1) / threads;
+#endif
+  const int ngroups = (K + group - 1) / group;
+  bool out_of_memory = false;
+  int g;
+#pragma omp parallel for schedule(dynamic,1) if (ngroups > 1)
+  for (g = 0; g < ngroups; g++)
+  {
+    const int first = g*group;
+    // exceptions must not leave the parallel region; rethrown below
+    try
+    {
+      qdct_saliency_group(axis, indata + first*MN*num_image_channels, outdata + first*MN,
+                          M, N, num_image_channels, (K - first < group ? K - first : group), do_normalization,
+                          GetQdctWorkspace<T>());
+    }
+    catch (const std::bad_alloc&)
+    {
+#pragma omp critical (qdct_saliency_out_of_memory)
+      out_of_memory = true;
+    }
+  }
+  if (out_of_memory)
+    throw std::bad_alloc();
+}
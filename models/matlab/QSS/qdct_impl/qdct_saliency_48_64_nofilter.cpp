@@ -60,9 +60,7 @@
 #include "matrix.h"
 #endif
 
-#include "signum.hpp"           // the quaternion signum function
-#include "hamilton_product.hpp" // the quaternion Hamilton product
-#include "dct_48_64.hpp"        // the type-II DCT and inverse DCT (optimized for 48x64 matrices, i.e. 64x48 images)
+#include "qdct_saliency.hpp"    // the QDCT saliency (for 48x64, the DCTs use the 48 and 64 element codelets)
 
 template <typename T>
 void
@@ -71,43 +69,9 @@ qdct_saliency_48_64(const T* axis, const T* indata, T* outdata, int num_image_ch
   const int M=48;
   const int N=64;
   
-  // temporary data
-  T tmp_first_axis_transform[M*N*4];  // output of 1.1
-  T tmp_dct[M*N*4];                   // output of 1.2
-  T tmp_signum[M*N*4];                // output of 2
-  T tmp_second_axis_transform[M*N*4]; // output of 3.1
-  T tmp_idct[M*N*4];                  // output of 3.2
-    
-  ////
-  // Processing
-  // ==========
-  // 1   QDCT
-  // 1.1 multiply image with axis (after that we definitely have 4 channels)
-  if (num_image_channels == 3)
-  {
-    HamiltonProductScalarMatrixImaginary_3c(axis,indata,tmp_first_axis_transform, M, N); // left-sided
-  }
-  else
-  {
-    HamiltonProductScalarMatrix_4c(axis,indata,tmp_first_axis_transform, M, N); // left-sided
-  }
-  // 1.2 dct for each of the 4 channels
-  for (int c = 0; c < 4; c++)
-  {
-    dct2_type2_48_64(&tmp_first_axis_transform[c*M*N], &tmp_dct[c*M*N], false);
-  }
-  // 2.  SIGNUM
-  Signum_4c(tmp_dct,tmp_signum,M,N);
-  // 3   IQDCT
-  // 3.1 multiply result with axis
-  HamiltonProductScalarMatrix_4c(axis,tmp_signum,tmp_second_axis_transform, M, N); // left-sided
-  // 3.2 idct
-  for (int c = 0; c < 4; c++)
-  {
-    idct2_type2_48_64(&tmp_second_axis_transform[c*M*N], &tmp_idct[c*M*N], false); // left-sided
-  }
-  // 4.  ABS
-  AbsSqr_4c(tmp_idct,outdata,M,N);
+  // in place on the reusable workspace of the calling thread (qdct_workspace.hpp),
+  // i.e. nothing is allocated on the stack
+  qdct_saliency(axis,indata,outdata,M,N,num_image_channels,false);
 }
 
 template <typename T>
@@ -170,7 +134,14 @@ _mexFunction(int nlhs, mxArray* plhs[],
   T* outdata=(T*)mxGetData(moutdata);
   
   mwSize nchannels = indims[2];
-  qdct_saliency_48_64(axis,indata,outdata,nchannels);
+  try // the temporary data may not fit into memory
+  {
+    qdct_saliency_48_64(axis,indata,outdata,nchannels);
+  }
+  catch (const std::bad_alloc&)
+  {
+    mexErrMsgTxt("Out of memory.");
+  }
 }
 
 void
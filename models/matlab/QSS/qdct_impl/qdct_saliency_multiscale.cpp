@@ -0,0 +1,149 @@
+/**
+ * If you use any of this work in scientific research or as part of a larger
+ * software system, you are kindly requested to cite the use in any related 
+ * publications or technical documentation. The work is based upon:
+ *
+ * [1] B. Schauerte, and R. Stiefelhagen, "Predicting Human Gaze using 
+ *     Quaternion DCT Image Signature Saliency and Face Detection," in IEEE 
+ *     Workshop on the Applications of Computer Vision (WACV), 2012.
+ * [2] B. Schauerte, and R. Stiefelhagen, "Quaternion-based Spectral 
+ *     Saliency Detection for Eye Fixation Prediction," in European 
+ *     Conference on Computer Vision (ECCV), 2012
+ */
+
+
+/** 
+ * Calculate the multi-scale quaterion DCT-II saliency in one call.
+ *
+ * The native counterpart of the 'quat:dct:multi' loop of
+ * spectral_saliency_multichannel: the image is resized to each scale, the
+ * QDCT saliency of each scale is calculated (in parallel, one scale per
+ * thread with OpenMP), resized to the target resolution, and the maps of
+ * all scales are summed.
+ */
+#include "dct_type2.hpp"
+
+#include <cmath>
+#include <climits>
+#include <vector>
+
+#ifdef __MEX
+#define __CONST__ const
+#include "mex.h"
+#include "matrix.h"
+#endif
+
+#include "qdct_saliency_multiscale.hpp" // the multi-scale QDCT saliency
+
+template void qdct_saliency_multiscale<>(const float*, const float*, int, int, int, const int*, int, int, int, float, bool, bool, float*);
+template void qdct_saliency_multiscale<>(const double*, const double*, int, int, int, const int*, int, int, int, double, bool, bool, double*);
+
+#ifdef __MEX
+template <typename T>
+void
+_mexFunction(int nlhs, mxArray* plhs[],
+             int nrhs, const mxArray* prhs[])
+{
+  __CONST__ mxArray *mindata = prhs[0];
+  const mwSize* indims=mxGetDimensions(mindata);
+
+  if (mxIsComplex(mindata))
+    mexErrMsgTxt("only real data allowed");
+
+  // the scales (one row per scale)
+  const mwSize num_scales = mxGetM(prhs[1]);
+  if (mxGetN(prhs[1]) != 2 || num_scales < 1)
+    mexErrMsgTxt("The scales need to be given as Kx2 matrix of image sizes.");
+  std::vector<int> sizes(2*num_scales);
+  for (mwSize r = 0; r < num_scales; r++)
+  {
+    const double m = mxGetPr(prhs[1])[r], n = mxGetPr(prhs[1])[r + num_scales];
+    if (!(m > 0 && n > 0 && m <= INT_MAX && n <= INT_MAX)) // also rejects NaN
+      mexErrMsgTxt("The image sizes of the scales need to be positive.");
+    sizes[2*r]     = (int)ceil(m);
+    sizes[2*r + 1] = (int)ceil(n);
+  }
+
+  // the target resolution
+  if (mxGetNumberOfElements(prhs[2]) != 2)
+    mexErrMsgTxt("The target resolution needs to be given as [M N].");
+  const double mt = mxGetPr(prhs[2])[0], nt = mxGetPr(prhs[2])[1];
+  if (!(mt >= 1 && nt >= 1 && mt <= INT_MAX && nt <= INT_MAX)) // also rejects NaN
+    mexErrMsgTxt("The target resolution needs to be positive.");
+  const int MT = (int)mt;
+  const int NT = (int)nt;
+
+  T default_axis[4] = {0, T(-1)/sqrt(T(3)), T(-1)/sqrt(T(3)), T(-1)/sqrt(T(3))}; // unit pure quaterion (i.e. unit(quaternion(-1,-1,-1)))
+  if (nrhs > 3 && !mxIsEmpty(prhs[3])) // check for bad axis definitions
+  {
+    if (mxGetNumberOfElements(prhs[3]) != 4)
+      mexErrMsgTxt("The axis needs to be defined as full quaternion, i.e. 4 elements (however, zero elements are allowed).");
+    if (mxGetClassID(prhs[3]) != mxGetClassID(mindata))
+      mexErrMsgTxt("The axis and the image need to have the same data type (float,double).");
+  }
+  const T* axis = (nrhs > 3 && !mxIsEmpty(prhs[3]) ? (T*)mxGetData(prhs[3]) : default_axis);
+
+  const T absexp = (nrhs > 4 ? T(mxGetScalar(prhs[4])) : T(2));
+  const bool do_normalize = (nrhs > 5 ? mxGetScalar(prhs[5]) > 0 : false);
+  const bool do_range_normalization = (nrhs > 6 ? mxGetScalar(prhs[6]) > 0 : true);
+
+  // create the output data
+  mwSize outdims[2] = {(mwSize)MT, (mwSize)NT};
+  mxArray *moutdata = mxCreateNumericArray(2, outdims, mxGetClassID(mindata), mxREAL);
+  plhs[0] = moutdata; 
+
+  // get the real data pointers
+  __CONST__ T* indata=(T*)mxGetData(mindata);
+  T* outdata=(T*)mxGetData(moutdata);
+
+  try // the temporary data may not fit into memory
+  {
+    qdct_saliency_multiscale(axis,indata,(int)indims[0],(int)indims[1],(int)indims[2],
+                             &sizes[0],(int)num_scales,MT,NT,absexp,do_normalize,
+                             do_range_normalization,outdata);
+  }
+  catch (const std::bad_alloc&)
+  {
+    mexErrMsgTxt("Out of memory.");
+  }
+}
+
+void
+mexFunction(int nlhs, mxArray* plhs[],
+            int nrhs, const mxArray* prhs[])
+{
+  // check number of input parameters
+  if (nrhs < 3 || nrhs > 7)
+    mexErrMsgTxt("input arguments: image scales target_resolution [axis] [absexp] [do_normalize] [do_range_normalization]");
+
+  // Check number of output parameters
+  if (nlhs > 1) 
+    mexErrMsgTxt("Wrong number of output arguments.");
+  
+  const mwSize* indims=mxGetDimensions(prhs[0]);
+  if (mxGetNumberOfDimensions(prhs[0]) < 3 || indims[2] < 3 || indims[2] > 4)
+    mexErrMsgTxt("The input image has to be MxNx3 or MxNx4");
+  if (indims[0] < 1 || indims[1] < 1)
+    mexErrMsgTxt("The input image must not be empty.");
+
+  if (!mxIsDouble(prhs[1]) || !mxIsDouble(prhs[2]))
+    mexErrMsgTxt("The scales and the target resolution need to be double.");
+  
+  // only float and double are currently supported
+  if (!mxIsDouble(prhs[0]) && !mxIsSingle(prhs[0])) 
+  	mexErrMsgTxt("Only float and double input arguments are supported.");
+  
+  switch (mxGetClassID(prhs[0]))
+  {
+    case mxDOUBLE_CLASS:
+      _mexFunction<double>(nlhs,plhs,nrhs,prhs);
+      break;
+    case mxSINGLE_CLASS:
+      _mexFunction<float>(nlhs,plhs,nrhs,prhs);
+      break;
+    default:
+      // this should never happen
+      break;
+  }
+}
+#endif
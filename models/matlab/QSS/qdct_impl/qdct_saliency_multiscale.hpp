@@ -0,0 +1,124 @@
+/**
+ * If you use any of this work in scientific research or as part of a larger
+ * software system, you are kindly requested to cite the use in any related 
+ * publications or technical documentation. The work is based upon:
+ *
+ * [1] B. Schauerte, and R. Stiefelhagen, "Predicting Human Gaze using 
+ *     Quaternion DCT Image Signature Saliency and Face Detection," in IEEE 
+ *     Workshop on the Applications of Computer Vision (WACV), 2012.
+ * [2] B. Schauerte, and R. Stiefelhagen, "Quaternion-based Spectral 
+ *     Saliency Detection for Eye Fixation Prediction," in European 
+ *     Conference on Computer Vision (ECCV), 2012
+ */
+
+
+/** 
+ * The multi-scale quaterion DCT-II saliency, i.e. the 'quat:dct:multi' loop
+ * of spectral_saliency_multichannel: the image is resized to each scale, the
+ * QDCT saliency of each scale is calculated (in parallel, one scale per
+ * thread with OpenMP), resized to the target resolution, and the maps of
+ * all scales are summed.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <vector>
+
+#include "qdct_saliency.hpp"    // the QDCT saliency for any size
+#include "imresize.hpp"         // bicubic resizing (as Matlab's imresize)
+
+/**
+ * The saliency of the MxN image at one scale (mxn), resized to the target
+ * resolution MTxNT:
+ *   imresize(spectral_dct_saliency_quaternion(imresize(I,[m n]),...),[MT NT])
+ */
+template <typename T>
+void
+qdct_saliency_scale(const T* axis, const T* indata, int M, int N, int num_image_channels,
+                    int m, int n, int MT, int NT, T absexp, bool do_normalize,
+                    bool do_range_normalization, T* outdata)
+{
+  std::vector<T> image(m*n*num_image_channels);
+  std::vector<T> saliency(m*n);
+  for (int c = 0; c < num_image_channels; c++)
+  {
+    ImresizeBicubic(indata + c*M*N, &image[c*m*n], M, N, m, n);
+  }
+  qdct_saliency(axis, &image[0], &saliency[0], m, n, num_image_channels, true);
+  // S=abs(IDCTIR).^absexp (the saliency is the squared absolute value)
+  if (absexp != T(2))
+  {
+    for (int i = 0; i < m*n; i++)
+      saliency[i] = pow(saliency[i], absexp / T(2));
+  }
+  if (do_normalize)
+  {
+    const T smin = *std::min_element(saliency.begin(), saliency.end());
+    for (int i = 0; i < m*n; i++)
+      saliency[i] -= smin;
+    const T smax = *std::max_element(saliency.begin(), saliency.end());
+    for (int i = 0; i < m*n; i++)
+      saliency[i] /= smax;
+  }
+  ImresizeBicubic(&saliency[0], outdata, m, n, MT, NT);
+  // mat2gray
+  if (do_range_normalization)
+  {
+    const T smin = *std::min_element(outdata, outdata + MT*NT);
+    const T smax = *std::max_element(outdata, outdata + MT*NT);
+    for (int i = 0; i < MT*NT; i++)
+      outdata[i] = (smax > smin ? (outdata[i] - smin) / (smax - smin) : T(0));
+  }
+}
+
+/**
+ * Sum of the saliency maps of num_scales scales (sizes: m_1, n_1, m_2, n_2,
+ * ...) at the target resolution MTxNT.
+ */
+template <typename T>
+void
+qdct_saliency_multiscale(const T* axis, const T* indata, int M, int N, int num_image_channels,
+                         const int* sizes, int num_scales, int MT, int NT, T absexp,
+                         bool do_normalize, bool do_range_normalization, T* outdata)
+{
+  std::vector<T> maps(num_scales*MT*NT);
+
+  // plan the DCTs first, so that the threads do not build them concurrently
+  for (int r = 0; r < num_scales; r++)
+  {
+    GetDctPlan<T>(sizes[2*r]);
+    GetDctPlan<T>(sizes[2*r + 1]);
+  }
+
+  bool out_of_memory = false;
+  int r;
+#pragma omp parallel for schedule(dynamic,1)
+  for (r = 0; r < num_scales; r++)
+  {
+    // exceptions must not leave the parallel region; rethrown below
+    try
+    {
+      qdct_saliency_scale(axis, indata, M, N, num_image_channels, sizes[2*r], sizes[2*r + 1],
+                          MT, NT, absexp, do_normalize, do_range_normalization, &maps[r*MT*NT]);
+    }
+    catch (const std::bad_alloc&)
+    {
+#pragma omp critical (qdct_saliency_multiscale_out_of_memory)
+      out_of_memory = true;
+    }
+  }
+  if (out_of_memory)
+    throw std::bad_alloc();
+
+  // fuse the maps (in the order of the scales, independent of the threads)
+  for (int i = 0; i < MT*NT; i++)
+    outdata[i] = maps[i];
+  for (r = 1; r < num_scales; r++)
+  {
+    const T* map = &maps[r*MT*NT];
+    for (int i = 0; i < MT*NT; i++)
+      outdata[i] += map[i];
+  }
+}
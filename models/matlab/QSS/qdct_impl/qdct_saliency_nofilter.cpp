@@ -0,0 +1,139 @@
+/**
+ * If you use any of this work in scientific research or as part of a larger
+ * software system, you are kindly requested to cite the use in any related 
+ * publications or technical documentation. The work is based upon:
+ *
+ * [1] B. Schauerte, and R. Stiefelhagen, "Predicting Human Gaze using 
+ *     Quaternion DCT Image Signature Saliency and Face Detection," in IEEE 
+ *     Workshop on the Applications of Computer Vision (WACV), 2012.
+ * [2] B. Schauerte, and R. Stiefelhagen, "Quaternion-based Spectral 
+ *     Saliency Detection for Eye Fixation Prediction," in European 
+ *     Conference on Computer Vision (ECCV), 2012
+ */
+
+
+/** 
+ * Calculate the quaterion DCT-II saliency for MxN matrices of any size.
+ *
+ * Same processing as qdct_saliency_48_64, but the DCTs are planned for the
+ * size of the input (dct_plan.hpp), so that the image does not need to be
+ * resized to 64x48 first.
+ *
+ * A stack of K images (MxNx3xK or MxNx4xK, e.g. the frames of a video) is
+ * processed in one call (qdct_saliency_batch); the result is MxNxK.
+ */
+#include "dct_type2.hpp"
+
+#include <cmath>
+
+#ifdef __MEX
+#define __CONST__ const
+#include "mex.h"
+#include "matrix.h"
+#endif
+
+#include "qdct_saliency.hpp"    // the QDCT saliency for any size
+
+#define _DEFAULT_DO_NORMALIATION (false)
+
+template <typename T>
+inline void
+qdct_saliency(const T* indata, T* outdata, int M, int N, int num_image_channels)
+{
+  T default_axis[4] = {0, T(-1)/sqrt(T(3)), T(-1)/sqrt(T(3)), T(-1)/sqrt(T(3))}; // unit pure quaterion (i.e. unit(quaternion(-1,-1,-1)))
+  
+  qdct_saliency(default_axis,indata,outdata,M,N,num_image_channels,_DEFAULT_DO_NORMALIATION);
+}
+        
+template void qdct_saliency<>(const float*, float*, int, int, int);
+template void qdct_saliency<>(const double*, double*, int, int, int);
+
+#ifdef __MEX
+template <typename T>
+void
+_mexFunction(int nlhs, mxArray* plhs[],
+             int nrhs, const mxArray* prhs[])
+{
+  __CONST__ mxArray *mindata = prhs[0];
+  
+  T default_axis[4] = {0, T(-1)/sqrt(T(3)), T(-1)/sqrt(T(3)), T(-1)/sqrt(T(3))}; // unit pure quaterion (i.e. unit(quaternion(-1,-1,-1)))
+  if (nrhs > 1 && !mxIsEmpty(prhs[1])) // check for bad axis definitions
+  {
+    if (mxGetNumberOfElements(prhs[1]) != 4)
+      mexErrMsgTxt("The axis needs to be defined as full quaternion, i.e. 4 elements (however, zero elements are allowed).");
+    if (mxGetClassID(prhs[1]) != mxGetClassID(mindata))
+      mexErrMsgTxt("The axis and the image need to have the same data type (float,double).");
+  }
+  const T* axis = (nrhs > 1 && !mxIsEmpty(prhs[1]) ? (T*)mxGetData(prhs[1]) : default_axis);
+
+  // shall we use the orthonormal DCT (as Matlab's dct2, or qdct2 of the QTFM)?
+  bool do_normalization = _DEFAULT_DO_NORMALIATION;
+  if (nrhs > 2)
+    do_normalization = (mxGetScalar(prhs[2]) > 0 ? true : false);
+
+  // create the output data (one saliency map per image)
+  const mwSize* indims=mxGetDimensions(mindata);
+  const mwSize nimages = (mxGetNumberOfDimensions(mindata) > 3 ? indims[3] : 1);
+  mwSize outdims[3] = {indims[0], indims[1], nimages};
+  
+  if (mxIsComplex(mindata))
+    mexErrMsgTxt("only real data allowed");
+
+  mxArray *moutdata = mxCreateNumericArray((nimages > 1 ? 3 : 2), outdims, mxGetClassID(mindata), mxREAL);
+  plhs[0] = moutdata; 
+
+  // get the real data pointers
+  __CONST__ T* indata=(T*)mxGetData(mindata);
+  T* outdata=(T*)mxGetData(moutdata);
+  
+  if (indims[0] == 0 || indims[1] == 0 || nimages == 0)
+    return;
+
+  mwSize nchannels = indims[2];
+  try // the temporary data may not fit into memory
+  {
+    if (nimages > 1)
+      qdct_saliency_batch(axis,indata,outdata,(int)indims[0],(int)indims[1],(int)nchannels,(int)nimages,do_normalization);
+    else
+      qdct_saliency(axis,indata,outdata,(int)indims[0],(int)indims[1],(int)nchannels,do_normalization);
+  }
+  catch (const std::bad_alloc&)
+  {
+    mexErrMsgTxt("Out of memory.");
+  }
+}
+
+void
+mexFunction(int nlhs, mxArray* plhs[],
+            int nrhs, const mxArray* prhs[])
+{
+  // check number of input parameters
+  if (nrhs < 1 || nrhs > 3)
+    mexErrMsgTxt("input arguments: image [axis] [do_normalization]");
+
+  // Check number of output parameters
+  if (nlhs > 1) 
+    mexErrMsgTxt("Wrong number of output arguments.");
+  
+  const mwSize* indims=mxGetDimensions(prhs[0]);
+  if (mxGetNumberOfDimensions(prhs[0]) < 3 || mxGetNumberOfDimensions(prhs[0]) > 4 || indims[2] < 3 || indims[2] > 4)
+    mexErrMsgTxt("The input image has to be MxNx3 or MxNx4 (or a stack of K images, MxNx3xK or MxNx4xK)");
+  
+  // only float and double are currently supported
+  if (!mxIsDouble(prhs[0]) && !mxIsSingle(prhs[0])) 
+  	mexErrMsgTxt("Only float and double input arguments are supported.");
+  
+  switch (mxGetClassID(prhs[0]))
+  {
+    case mxDOUBLE_CLASS:
+      _mexFunction<double>(nlhs,plhs,nrhs,prhs);
+      break;
+    case mxSINGLE_CLASS:
+      _mexFunction<float>(nlhs,plhs,nrhs,prhs);
+      break;
+    default:
+      // this should never happen
+      break;
+  }
+}
+#endif
@@ -0,0 +1,114 @@
+/**
+ * Reusable, aligned temporary data of the QDCT saliency (qdct_saliency.hpp).
+ *
+ * Implementation notes:
+ * --------------------
+ * - the saliency is computed in place on one quaternion buffer (4 channels);
+ *   the 2-D DCTs need one more (chunk of) channel(s) and the scratch of the
+ *   DCT plans. Nothing is allocated on the stack.
+ * - a workspace only grows, i.e. it is allocated once for the largest images
+ *   and then reused across calls
+ * - GetQdctWorkspace returns the workspace of the calling thread (thread_local,
+ *   i.e. also for plain std::threads/pthreads and nested OpenMP teams, for
+ *   which omp_get_thread_num() is not unique); it is freed when the thread
+ *   exits
+ */
+#pragma once
+
+#include <complex>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "dct_plan.hpp"
+
+/** Alignment (bytes) of the workspace buffers (a cache line) */
+#ifndef QDCT_WORKSPACE_ALIGNMENT
+#define QDCT_WORKSPACE_ALIGNMENT 64
+#endif
+
+/**
+ * Memory block with QDCT_WORKSPACE_ALIGNMENT-aligned start that keeps its
+ * contents only until it grows.
+ */
+class QdctAlignedBuffer
+{
+public:
+  QdctAlignedBuffer() : raw(0), data(0), bytes(0) {}
+  ~QdctAlignedBuffer() { std::free(raw); }
+
+  /** at least _bytes bytes; throws std::bad_alloc (and is empty) on failure */
+  void*
+  reserve(size_t _bytes)
+  {
+    if (_bytes > bytes)
+    {
+      std::free(raw);
+      raw = data = 0;
+      bytes = 0;
+      if (_bytes > (size_t)-1 - QDCT_WORKSPACE_ALIGNMENT)
+        throw std::bad_alloc();
+      raw = std::malloc(_bytes + QDCT_WORKSPACE_ALIGNMENT);
+      if (!raw)
+        throw std::bad_alloc();
+      data = (void*)(((size_t)raw + QDCT_WORKSPACE_ALIGNMENT - 1) & ~(size_t)(QDCT_WORKSPACE_ALIGNMENT - 1));
+      bytes = _bytes;
+    }
+    return data;
+  }
+
+private:
+  QdctAlignedBuffer(const QdctAlignedBuffer&);
+  QdctAlignedBuffer& operator=(const QdctAlignedBuffer&);
+
+  void* raw;
+  void* data;
+  size_t bytes;
+};
+
+/**
+ * Temporary data for the saliency of K MxN images at a time.
+ */
+template <typename T>
+class QdctWorkspace
+{
+public:
+  typedef std::complex<T> C;
+
+  QdctWorkspace() : quaternion(0), channel(0), scratch(0) {}
+
+  /** make room for K MxN images (the previous contents are lost) */
+  void
+  reserve(int M, int N, int K = 1)
+  {
+    const size_t MN = (size_t)M*N;
+    const int chunk = DctBatchChunk(N);
+    const int scratch_size = std::max(GetDctPlan<T>(M).scratch_size(), GetDctPlan<T>(N).scratch_size());
+    quaternion = (T*)quaternion_buffer.reserve(4*MN*K*sizeof(T));
+    channel = (T*)channel_buffer.reserve(MN*std::min(chunk, 4*K)*sizeof(T));
+    scratch = (C*)scratch_buffer.reserve(scratch_size*sizeof(C));
+  }
+
+  T* quaternion; // 4 channels of K images (4*M*N*K)
+  T* channel;    // temporary data of the 2-D DCTs (dct2_type2_batch)
+  C* scratch;    // scratch of the DCT plans
+
+private:
+  QdctWorkspace(const QdctWorkspace&);
+  QdctWorkspace& operator=(const QdctWorkspace&);
+
+  QdctAlignedBuffer quaternion_buffer;
+  QdctAlignedBuffer channel_buffer;
+  QdctAlignedBuffer scratch_buffer;
+};
+
+/** The workspace of the calling thread */
+template <typename T>
+QdctWorkspace<T>&
+GetQdctWorkspace()
+{
+  static thread_local std::unique_ptr<QdctWorkspace<T> > workspace;
+  if (!workspace)
+    workspace.reset(new QdctWorkspace<T>());
+  return *workspace;
+}
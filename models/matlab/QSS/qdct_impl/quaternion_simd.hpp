@@ -0,0 +1,466 @@
+/**
+ * Vectorized versions of the element-wise quaternion functions of the QDCT
+ * saliency (ScaledSignum_3c/_4c and AbsSqr_3c/_4c of signum.hpp), for the
+ * same planar (non-interleaved) channels.
+ *
+ * Implementation notes:
+ * --------------------
+ * - the instruction set is chosen at runtime (GetQuaternionSimdLevel):
+ *   AVX-512F, AVX2+FMA or SSE2 on x86, NEON on 64-bit ARM, and the scalar
+ *   functions of signum.hpp otherwise (or with QUATERNION_SIMD_DISABLE)
+ * - the kernels are written once (quaternion_simd_kernels.inc) and compiled
+ *   for each instruction set with the target attributes of GCC/Clang, i.e.
+ *   no additional compiler flags are needed
+ * - single precision uses the reciprocal square root estimate with Newton
+ *   refinement (one step from the 12/14 bit estimates of x86, two from the
+ *   8 bit estimate of NEON); squared norms that are denormal or infinite
+ *   fall back to the scalar code. Double precision divides by the square
+ *   root, since the refinement to 53 bits costs as much.
+ * - zeros (and NaNs) are handled without branches by masking the lanes whose
+ *   squared norm is not positive (as signum.hpp, they become 0)
+ */
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "signum.hpp"
+
+#if !defined(QUATERNION_SIMD_DISABLE)
+#if defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define QUATERNION_SIMD_X86
+#if defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define QUATERNION_SIMD_X86_AVX // per-function targets for AVX2 and AVX-512
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define QUATERNION_SIMD_NEON
+#endif
+#endif
+
+#if defined(QUATERNION_SIMD_X86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#elif defined(QUATERNION_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define QUATERNION_SIMD_TARGET_AVX2
+#define QUATERNION_SIMD_TARGET_AVX512
+#else
+#define QUATERNION_SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define QUATERNION_SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+/** The instruction sets of the vectorized quaternion functions */
+enum QuaternionSimdLevel
+{
+  QUATERNION_SIMD_SCALAR = 0,
+  QUATERNION_SIMD_SSE2,
+  QUATERNION_SIMD_AVX2,
+  QUATERNION_SIMD_AVX512,
+  QUATERNION_SIMD_NEON
+};
+
+#if defined(QUATERNION_SIMD_X86)
+
+namespace quaternion_simd_sse2
+{
+  struct VecFloat
+  {
+    typedef float T;
+    typedef __m128 R;
+    typedef __m128 Mask;
+    enum { W = 4 };
+    static inline R set1(T x) { return _mm_set1_ps(x); }
+    static inline R zero() { return _mm_setzero_ps(); }
+    static inline R load(const T* p) { return _mm_loadu_ps(p); }
+    static inline void store(T* p, R x) { _mm_storeu_ps(p, x); }
+    static inline R mul(R a, R b) { return _mm_mul_ps(a, b); }
+    static inline R fmadd(R a, R b, R c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static inline Mask gt_zero(R x) { return _mm_cmpgt_ps(x, _mm_setzero_ps()); }
+    static inline R select(Mask m, R x) { return _mm_and_ps(m, x); }
+    static inline bool
+    any_outside_range(R x)
+    {
+      const __m128 outside = _mm_or_ps(_mm_cmplt_ps(x, _mm_set1_ps(std::numeric_limits<T>::min())),
+                                       _mm_cmpgt_ps(x, _mm_set1_ps(std::numeric_limits<T>::max())));
+      return _mm_movemask_ps(_mm_and_ps(gt_zero(x), outside)) != 0;
+    }
+    static inline R
+    rsqrt(R x)
+    {
+      const R y = _mm_rsqrt_ps(x);
+      // y (1.5 - 0.5 x y^2)
+      return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), x), _mm_mul_ps(y, y))));
+    }
+  };
+
+  struct VecDouble
+  {
+    typedef double T;
+    typedef __m128d R;
+    typedef __m128d Mask;
+    enum { W = 2 };
+    static inline R set1(T x) { return _mm_set1_pd(x); }
+    static inline R zero() { return _mm_setzero_pd(); }
+    static inline R load(const T* p) { return _mm_loadu_pd(p); }
+    static inline void store(T* p, R x) { _mm_storeu_pd(p, x); }
+    static inline R mul(R a, R b) { return _mm_mul_pd(a, b); }
+    static inline R fmadd(R a, R b, R c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static inline Mask gt_zero(R x) { return _mm_cmpgt_pd(x, _mm_setzero_pd()); }
+    static inline R select(Mask m, R x) { return _mm_and_pd(m, x); }
+    static inline bool any_outside_range(R) { return false; }
+    static inline R rsqrt(R x) { return _mm_div_pd(_mm_set1_pd(1.0), _mm_sqrt_pd(x)); }
+  };
+
+#define QUATERNION_SIMD_TARGET
+#include "quaternion_simd_kernels.inc"
+#undef QUATERNION_SIMD_TARGET
+}
+
+#if defined(QUATERNION_SIMD_X86_AVX)
+
+namespace quaternion_simd_avx2
+{
+  struct VecFloat
+  {
+    typedef float T;
+    typedef __m256 R;
+    typedef __m256 Mask;
+    enum { W = 8 };
+    static inline QUATERNION_SIMD_TARGET_AVX2 R set1(T x) { return _mm256_set1_ps(x); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R zero() { return _mm256_setzero_ps(); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R load(const T* p) { return _mm256_loadu_ps(p); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 void store(T* p, R x) { _mm256_storeu_ps(p, x); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R mul(R a, R b) { return _mm256_mul_ps(a, b); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R fmadd(R a, R b, R c) { return _mm256_fmadd_ps(a, b, c); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 Mask gt_zero(R x) { return _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R select(Mask m, R x) { return _mm256_and_ps(m, x); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 bool
+    any_outside_range(R x)
+    {
+      const __m256 outside = _mm256_or_ps(_mm256_cmp_ps(x, _mm256_set1_ps(std::numeric_limits<T>::min()), _CMP_LT_OQ),
+                                          _mm256_cmp_ps(x, _mm256_set1_ps(std::numeric_limits<T>::max()), _CMP_GT_OQ));
+      return _mm256_movemask_ps(_mm256_and_ps(gt_zero(x), outside)) != 0;
+    }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R
+    rsqrt(R x)
+    {
+      const R y = _mm256_rsqrt_ps(x);
+      // y (1.5 - 0.5 x y^2)
+      return _mm256_mul_ps(y, _mm256_fnmadd_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), x), _mm256_mul_ps(y, y), _mm256_set1_ps(1.5f)));
+    }
+  };
+
+  struct VecDouble
+  {
+    typedef double T;
+    typedef __m256d R;
+    typedef __m256d Mask;
+    enum { W = 4 };
+    static inline QUATERNION_SIMD_TARGET_AVX2 R set1(T x) { return _mm256_set1_pd(x); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R zero() { return _mm256_setzero_pd(); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R load(const T* p) { return _mm256_loadu_pd(p); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 void store(T* p, R x) { _mm256_storeu_pd(p, x); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R mul(R a, R b) { return _mm256_mul_pd(a, b); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R fmadd(R a, R b, R c) { return _mm256_fmadd_pd(a, b, c); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 Mask gt_zero(R x) { return _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_GT_OQ); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R select(Mask m, R x) { return _mm256_and_pd(m, x); }
+    static inline QUATERNION_SIMD_TARGET_AVX2 bool any_outside_range(R) { return false; }
+    static inline QUATERNION_SIMD_TARGET_AVX2 R rsqrt(R x) { return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(x)); }
+  };
+
+#define QUATERNION_SIMD_TARGET QUATERNION_SIMD_TARGET_AVX2
+#include "quaternion_simd_kernels.inc"
+#undef QUATERNION_SIMD_TARGET
+}
+
+namespace quaternion_simd_avx512
+{
+  struct VecFloat
+  {
+    typedef float T;
+    typedef __m512 R;
+    typedef __mmask16 Mask;
+    enum { W = 16 };
+    static inline QUATERNION_SIMD_TARGET_AVX512 R set1(T x) { return _mm512_set1_ps(x); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R zero() { return _mm512_setzero_ps(); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R load(const T* p) { return _mm512_loadu_ps(p); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 void store(T* p, R x) { _mm512_storeu_ps(p, x); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R mul(R a, R b) { return _mm512_mul_ps(a, b); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R fmadd(R a, R b, R c) { return _mm512_fmadd_ps(a, b, c); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 Mask gt_zero(R x) { return _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_GT_OQ); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R select(Mask m, R x) { return _mm512_maskz_mov_ps(m, x); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 bool
+    any_outside_range(R x)
+    {
+      const __mmask16 outside = _mm512_cmp_ps_mask(x, _mm512_set1_ps(std::numeric_limits<T>::min()), _CMP_LT_OQ) |
+                                _mm512_cmp_ps_mask(x, _mm512_set1_ps(std::numeric_limits<T>::max()), _CMP_GT_OQ);
+      return (gt_zero(x) & outside) != 0;
+    }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R
+    rsqrt(R x)
+    {
+      const R y = _mm512_maskz_rsqrt14_ps(0xFFFF, x);
+      // y (1.5 - 0.5 x y^2)
+      return _mm512_mul_ps(y, _mm512_fnmadd_ps(_mm512_mul_ps(_mm512_set1_ps(0.5f), x), _mm512_mul_ps(y, y), _mm512_set1_ps(1.5f)));
+    }
+  };
+
+  struct VecDouble
+  {
+    typedef double T;
+    typedef __m512d R;
+    typedef __mmask8 Mask;
+    enum { W = 8 };
+    static inline QUATERNION_SIMD_TARGET_AVX512 R set1(T x) { return _mm512_set1_pd(x); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R zero() { return _mm512_setzero_pd(); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R load(const T* p) { return _mm512_loadu_pd(p); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 void store(T* p, R x) { _mm512_storeu_pd(p, x); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R mul(R a, R b) { return _mm512_mul_pd(a, b); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R fmadd(R a, R b, R c) { return _mm512_fmadd_pd(a, b, c); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 Mask gt_zero(R x) { return _mm512_cmp_pd_mask(x, _mm512_setzero_pd(), _CMP_GT_OQ); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R select(Mask m, R x) { return _mm512_maskz_mov_pd(m, x); }
+    static inline QUATERNION_SIMD_TARGET_AVX512 bool any_outside_range(R) { return false; }
+    static inline QUATERNION_SIMD_TARGET_AVX512 R rsqrt(R x) { return _mm512_div_pd(_mm512_set1_pd(1.0), _mm512_sqrt_pd(x)); }
+  };
+
+#define QUATERNION_SIMD_TARGET QUATERNION_SIMD_TARGET_AVX512
+#include "quaternion_simd_kernels.inc"
+#undef QUATERNION_SIMD_TARGET
+}
+
+#endif // QUATERNION_SIMD_X86_AVX
+
+#elif defined(QUATERNION_SIMD_NEON)
+
+namespace quaternion_simd_neon
+{
+  struct VecFloat
+  {
+    typedef float T;
+    typedef float32x4_t R;
+    typedef uint32x4_t Mask;
+    enum { W = 4 };
+    static inline R set1(T x) { return vdupq_n_f32(x); }
+    static inline R zero() { return vdupq_n_f32(0); }
+    static inline R load(const T* p) { return vld1q_f32(p); }
+    static inline void store(T* p, R x) { vst1q_f32(p, x); }
+    static inline R mul(R a, R b) { return vmulq_f32(a, b); }
+    static inline R fmadd(R a, R b, R c) { return vfmaq_f32(c, a, b); }
+    static inline Mask gt_zero(R x) { return vcgtq_f32(x, vdupq_n_f32(0)); }
+    static inline R select(Mask m, R x) { return vreinterpretq_f32_u32(vandq_u32(m, vreinterpretq_u32_f32(x))); }
+    static inline bool
+    any_outside_range(R x)
+    {
+      const uint32x4_t outside = vorrq_u32(vcltq_f32(x, vdupq_n_f32(std::numeric_limits<T>::min())),
+                                           vcgtq_f32(x, vdupq_n_f32(std::numeric_limits<T>::max())));
+      return vmaxvq_u32(vandq_u32(gt_zero(x), outside)) != 0;
+    }
+    static inline R
+    rsqrt(R x)
+    {
+      R y = vrsqrteq_f32(x);
+      y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y)); // y (3 - x y^2) / 2
+      y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y));
+      return y;
+    }
+  };
+
+  struct VecDouble
+  {
+    typedef double T;
+    typedef float64x2_t R;
+    typedef uint64x2_t Mask;
+    enum { W = 2 };
+    static inline R set1(T x) { return vdupq_n_f64(x); }
+    static inline R zero() { return vdupq_n_f64(0); }
+    static inline R load(const T* p) { return vld1q_f64(p); }
+    static inline void store(T* p, R x) { vst1q_f64(p, x); }
+    static inline R mul(R a, R b) { return vmulq_f64(a, b); }
+    static inline R fmadd(R a, R b, R c) { return vfmaq_f64(c, a, b); }
+    static inline Mask gt_zero(R x) { return vcgtq_f64(x, vdupq_n_f64(0)); }
+    static inline R select(Mask m, R x) { return vreinterpretq_f64_u64(vandq_u64(m, vreinterpretq_u64_f64(x))); }
+    static inline bool any_outside_range(R) { return false; }
+    static inline R rsqrt(R x) { return vdivq_f64(vdupq_n_f64(1.0), vsqrtq_f64(x)); }
+  };
+
+#define QUATERNION_SIMD_TARGET
+#include "quaternion_simd_kernels.inc"
+#undef QUATERNION_SIMD_TARGET
+}
+
+#endif
+
+/** The best instruction set of this CPU (determined once) */
+inline QuaternionSimdLevel
+DetectQuaternionSimdLevel()
+{
+#if defined(QUATERNION_SIMD_X86)
+#if defined(QUATERNION_SIMD_X86_AVX)
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  const int max_leaf = info[0];
+  __cpuid(info, 1);
+  const bool fma = (info[2] & (1 << 12)) != 0;
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  if (osxsave && max_leaf >= 7)
+  {
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    if ((info[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6) // AVX-512F, with ZMM/opmask state
+      return QUATERNION_SIMD_AVX512;
+    if ((info[1] & (1 << 5)) && fma && (xcr0 & 0x6) == 0x6) // AVX2, with YMM state
+      return QUATERNION_SIMD_AVX2;
+  }
+#else
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return QUATERNION_SIMD_AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return QUATERNION_SIMD_AVX2;
+#endif
+#endif
+  return QUATERNION_SIMD_SSE2;
+#elif defined(QUATERNION_SIMD_NEON)
+  return QUATERNION_SIMD_NEON;
+#else
+  return QUATERNION_SIMD_SCALAR;
+#endif
+}
+
+inline QuaternionSimdLevel
+GetQuaternionSimdLevel()
+{
+  static const QuaternionSimdLevel level = DetectQuaternionSimdLevel();
+  return level;
+}
+
+#if defined(QUATERNION_SIMD_X86_AVX)
+#define QUATERNION_SIMD_DISPATCH(call) \
+  switch (GetQuaternionSimdLevel()) \
+  { \
+    case QUATERNION_SIMD_AVX512: quaternion_simd_avx512::call; return; \
+    case QUATERNION_SIMD_AVX2: quaternion_simd_avx2::call; return; \
+    default: quaternion_simd_sse2::call; return; \
+  }
+#elif defined(QUATERNION_SIMD_X86)
+#define QUATERNION_SIMD_DISPATCH(call) { quaternion_simd_sse2::call; return; }
+#elif defined(QUATERNION_SIMD_NEON)
+#define QUATERNION_SIMD_DISPATCH(call) { quaternion_simd_neon::call; return; }
+#else
+#define QUATERNION_SIMD_DISPATCH(call)
+#endif
+
+/**
+ * Vectorized ScaledSignum_4c (float and double; other types use the scalar code).
+ * 4 input channels, 4 output channels
+ */
+template <typename T, typename S>
+inline void
+ScaledSignumSimd_4c(const T* A, T* B, const T scale, const S M, const S N)
+{
+    ScaledSignum_4c(A, B, scale, M, N);
+}
+
+template <typename S>
+inline void
+ScaledSignumSimd_4c(const float* A, float* B, const float scale, const S M, const S N)
+{
+    QUATERNION_SIMD_DISPATCH(ScaledSignum_4c(A, B, scale, (size_t)M*N))
+    ScaledSignum_4c(A, B, scale, M, N);
+}
+
+template <typename S>
+inline void
+ScaledSignumSimd_4c(const double* A, double* B, const double scale, const S M, const S N)
+{
+    QUATERNION_SIMD_DISPATCH(ScaledSignum_4c(A, B, scale, (size_t)M*N))
+    ScaledSignum_4c(A, B, scale, M, N);
+}
+
+/**
+ * Vectorized ScaledSignum_3c (float and double; other types use the scalar code).
+ * 3 input channels, 3 output channels
+ */
+template <typename T, typename S>
+inline void
+ScaledSignumSimd_3c(const T* A, T* B, const T scale, const S M, const S N)
+{
+    ScaledSignum_3c(A, B, scale, M, N);
+}
+
+template <typename S>
+inline void
+ScaledSignumSimd_3c(const float* A, float* B, const float scale, const S M, const S N)
+{
+    QUATERNION_SIMD_DISPATCH(ScaledSignum_3c(A, B, scale, (size_t)M*N))
+    ScaledSignum_3c(A, B, scale, M, N);
+}
+
+template <typename S>
+inline void
+ScaledSignumSimd_3c(const double* A, double* B, const double scale, const S M, const S N)
+{
+    QUATERNION_SIMD_DISPATCH(ScaledSignum_3c(A, B, scale, (size_t)M*N))
+    ScaledSignum_3c(A, B, scale, M, N);
+}
+
+/**
+ * Vectorized AbsSqr_4c (float and double; other types use the scalar code).
+ * 4 input channels, 1 output channels
+ */
+template <typename T, typename S>
+inline void
+AbsSqrSimd_4c(const T* A, T* B, const S M, const S N)
+{
+    AbsSqr_4c(A, B, M, N);
+}
+
+template <typename S>
+inline void
+AbsSqrSimd_4c(const float* A, float* B, const S M, const S N)
+{
+    QUATERNION_SIMD_DISPATCH(AbsSqr_4c(A, B, (size_t)M*N))
+    AbsSqr_4c(A, B, M, N);
+}
+
+template <typename S>
+inline void
+AbsSqrSimd_4c(const double* A, double* B, const S M, const S N)
+{
+    QUATERNION_SIMD_DISPATCH(AbsSqr_4c(A, B, (size_t)M*N))
+    AbsSqr_4c(A, B, M, N);
+}
+
+/**
+ * Vectorized AbsSqr_3c (float and double; other types use the scalar code).
+ * 3 input channels, 1 output channels
+ */
+template <typename T, typename S>
+inline void
+AbsSqrSimd_3c(const T* A, T* B, const S M, const S N)
+{
+    AbsSqr_3c(A, B, M, N);
+}
+
+template <typename S>
+inline void
+AbsSqrSimd_3c(const float* A, float* B, const S M, const S N)
+{
+    QUATERNION_SIMD_DISPATCH(AbsSqr_3c(A, B, (size_t)M*N))
+    AbsSqr_3c(A, B, M, N);
+}
+
+template <typename S>
+inline void
+AbsSqrSimd_3c(const double* A, double* B, const S M, const S N)
+{
+    QUATERNION_SIMD_DISPATCH(AbsSqr_3c(A, B, (size_t)M*N))
+    AbsSqr_3c(A, B, M, N);
+}
@@ -241,3 +241,75 @@ Signum_3c(const T* A, T* B, const S M, const S N)
       }
     }
 }
+
+/** 
+ * Calculate the signum function for each element of a quaternion matrix, multiplied with a (real) scale. 
+ * 4 input channels, 4 output channels
+ */
+template <typename T, typename S>
+inline void 
+ScaledSignum_4c(const T* A, T* B, const T scale, const S M, const S N)
+{
+    const S MN = M*N;
+    const T* Aa = A + 0*MN;
+    const T* Ab = A + 1*MN;
+    const T* Ac = A + 2*MN;
+    const T* Ad = A + 3*MN;
+    T* Ba = B + 0*MN;
+    T* Bb = B + 1*MN;
+    T* Bc = B + 2*MN;
+    T* Bd = B + 3*MN;
+    for (S i = 0; i < MN; i++)
+    {
+      const T abs = QUATERNION_ABS(Aa[i],Ab[i],Ac[i],Ad[i]);
+      if (abs > 0)
+      {
+        const T s = scale / abs;
+        Ba[i] = Aa[i] * s;
+        Bb[i] = Ab[i] * s;
+        Bc[i] = Ac[i] * s;
+        Bd[i] = Ad[i] * s;
+      }
+      else
+      {
+        Ba[i] = 0;
+        Bb[i] = 0;
+        Bc[i] = 0;
+        Bd[i] = 0;
+      }
+    }
+}
+
+/** 
+ * Calculate the signum function for each element of a quaternion matrix, multiplied with a (real) scale. 
+ * 3 input channels, 3 output channels
+ */
+template <typename T, typename S>
+inline void 
+ScaledSignum_3c(const T* A, T* B, const T scale, const S M, const S N)
+{
+    const S MN = M*N;
+    const T* Aa = A + 0*MN;
+    const T* Ab = A + 1*MN;
+    const T* Ac = A + 2*MN;
+    T* Ba = B + 0*MN;
+    T* Bb = B + 1*MN;
+    T* Bc = B + 2*MN;
+    for (S i = 0; i < MN; i++)
+    {
+      const T abs = QUATERNION_ABS(Aa[i],Ab[i],Ac[i],0);
+      if (abs > 0)
+      {
+        const T s = scale / abs;
+        Ba[i] = Aa[i] * s;
+        Bb[i] = Ab[i] * s;
+        Bc[i] = Ac[i] * s;
+      }
+      else
+      {
+        Ba[i] = 0;
+        Bb[i] = 0;
+        Bc[i] = 0;
+      }
+    }
+}
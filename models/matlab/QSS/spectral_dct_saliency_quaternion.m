@@ -50,6 +50,11 @@ function [S,DCTIR,IDCTIR]=spectral_dct_saliency_quaternion(I,absexp,dctaxis,L,do
     if isempty(which('qtfm_root')), error('The QTFM library is required.'); end
   end 
   
+  % the compiled QDCT saliency (see qdct_impl/build.m) is used if available
+  if exist('qdct_saliency','file') ~= 3
+    addpath(fullfile(fileparts(mfilename('fullpath')),'qdct_impl'));
+  end
+  
   if ~isfloat(I)
     I=im2double(I);
   end
@@ -61,23 +66,30 @@ function [S,DCTIR,IDCTIR]=spectral_dct_saliency_quaternion(I,absexp,dctaxis,L,do
   
   nchannels=size(I,3);
   
-  % create the quaternion image
-  switch nchannels
-    case {3}
-      QIR=quaternion(I(:,:,1),I(:,:,2),I(:,:,3)); 
+  mu=unit(dctaxis); % ensure a unit (pure) quaternion as axis
+  
+  if nargout < 2 && L == 'L' && (nchannels == 3 || nchannels == 4) && exist('qdct_saliency','file') == 3
+    % the compiled implementation (qdct_impl) for images of any size; with
+    % the orthonormal DCT it calculates the same map as qdct2/iqdct2
+    S=qdct_saliency(I,cast([0 x(mu) y(mu) z(mu)],class(I)),true).^(absexp/2);
+  else
+    % create the quaternion image
+    switch nchannels
+      case {3}
+        QIR=quaternion(I(:,:,1),I(:,:,2),I(:,:,3)); 
 
-    case {4}
-      QIR=quaternion(I(:,:,1),I(:,:,2),I(:,:,3),I(:,:,4));
+      case {4}
+        QIR=quaternion(I(:,:,1),I(:,:,2),I(:,:,3),I(:,:,4));
 
-    otherwise
-      error('unsupported number of image dimensions/channels')
+      otherwise
+        error('unsupported number of image dimensions/channels')
+    end
+    
+    DCTIR=qdct2(QIR,mu,L);
+    IDCTIR=iqdct2(sign(DCTIR),mu,L);
+    S=abs(IDCTIR).^absexp;
   end
   
-  mu=unit(dctaxis); % ensure a unit (pure) quaternion as axis
-  DCTIR=qdct2(QIR,mu,L);
-  IDCTIR=iqdct2(sign(DCTIR),mu,L);
-  S=abs(IDCTIR).^absexp;
-  
   if do_normalize
     S=S-min(min(S));
     S=S/max(max(S));
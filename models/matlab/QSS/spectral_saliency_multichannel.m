@@ -26,9 +26,8 @@ function S=spectral_saliency_multichannel(I,imsize,multichannel_method,smap_smoo
   %                   'quat:fft:eigenpqft'.
   %   'quat:dct'      Converts the image into a quaternion-based 
   %                   representation, uses quaternion DCT/IDCT operations.
-  %   'quat:dct:fast' Same as 'quad:dct', but with a fixed image 
-  %                   resolution of 64x48 and uses optimized .mex files for
-  %                   faster calculation.
+  %   'quat:dct:fast' Same as 'quad:dct', but uses optimized .mex files for
+  %                   faster calculation (at any image resolution).
   %   'fft:whitening:multi','fft:residual:multi','quat:dct:multi',
   %   'quat:pqft:multi','quat:fft:eigensr:multi','quat:fft:eigenpqft:multi'
   %                   The multi-scale versions of the above described
@@ -949,36 +948,49 @@ function S=spectral_saliency_multichannel(I,imsize,multichannel_method,smap_smoo
           resolutions{r}=resolutions{r-1}*scale_factor;
         end
       end
-      S=zeros([tresolution numel(resolutions)]);
-      for r=1:numel(resolutions)
-        % normalize the range of the saliency maps
-        S(:,:,r)=imresize(spectral_dct_saliency_quaternion(imresize(I,resolutions{r},'bicubic'),absexp,dctaxis,L,do_normalize),tresolution,'bicubic');
+      if exist('qdct_saliency_multiscale','file') ~= 3
+        addpath(fullfile(fileparts(mfilename('fullpath')),'qdct_impl'));
+      end
+      if ~do_separate_scale_filtering && L == 'L' && (size(I,3) == 3 || size(I,3) == 4) && exist('qdct_saliency_multiscale','file') == 3
+        % all scales in one call: the scales are resized, processed (in
+        % parallel), resized back and summed by qdct_impl/qdct_saliency_multiscale
+        if ~isfloat(I)
+          I=im2double(I);
+        end
+        mu=unit(dctaxis);
+        S=qdct_saliency_multiscale(I,cat(1,resolutions{:}),tresolution,cast([0 x(mu) y(mu) z(mu)],class(I)),absexp,do_normalize,do_range_normalization);
+      else
+        S=zeros([tresolution numel(resolutions)]);
+        for r=1:numel(resolutions)
+          % normalize the range of the saliency maps
+          S(:,:,r)=imresize(spectral_dct_saliency_quaternion(imresize(I,resolutions{r},'bicubic'),absexp,dctaxis,L,do_normalize),tresolution,'bicubic');
         
-        % use a different filter size for each scale (derived from the size of the filter on the target scale)
-        if do_separate_scale_filtering
-          if ~isempty(smap_smoothing_filter_params)
-            if ischar(smap_smoothing_filter_params{1}) && strcmp('anigauss',smap_smoothing_filter_params{1})
-              relative_sigma = smap_smoothing_filter_params{2} / tresolution(2);
-              resolution = resolutions{r};
+          % use a different filter size for each scale (derived from the size of the filter on the target scale)
+          if do_separate_scale_filtering
+            if ~isempty(smap_smoothing_filter_params)
+              if ischar(smap_smoothing_filter_params{1}) && strcmp('anigauss',smap_smoothing_filter_params{1})
+                relative_sigma = smap_smoothing_filter_params{2} / tresolution(2);
+                resolution = resolutions{r};
               
-              S(:,:,r)=anigauss(S(:,:,r),relative_sigma*resolution(2));
-            else
-              relative_sigma = smap_smoothing_filter_params{3} / tresolution(2);
-              resolution = resolutions{r};
-              tmp_smoothing_filter_params = smap_smoothing_filter_params;
-              tmp_smoothing_filter_params{3} = relative_sigma*resolution(2);
+                S(:,:,r)=anigauss(S(:,:,r),relative_sigma*resolution(2));
+              else
+                relative_sigma = smap_smoothing_filter_params{3} / tresolution(2);
+                resolution = resolutions{r};
+                tmp_smoothing_filter_params = smap_smoothing_filter_params;
+                tmp_smoothing_filter_params{3} = relative_sigma*resolution(2);
               
-              S(:,:,r)=imfilter(S(:,:,r), fspecial(tmp_smoothing_filter_params{:}));
+                S(:,:,r)=imfilter(S(:,:,r), fspecial(tmp_smoothing_filter_params{:}));
+              end
             end
           end
-        end
         
-        % normalize the range of each map to [0,1]
-        if do_range_normalization
-          S(:,:,r)=mat2gray(S(:,:,r));
+          % normalize the range of each map to [0,1]
+          if do_range_normalization
+            S(:,:,r)=mat2gray(S(:,:,r));
+          end
         end
+        S=sum(S,3);
       end
-      S=sum(S,3);
       %toc
       
       if ~do_separate_scale_filtering
@@ -999,23 +1011,33 @@ function S=spectral_saliency_multichannel(I,imsize,multichannel_method,smap_smoo
       % @note: it is possible that this breaks the anisotropic gauss filter
       %   implementation, because anigauss then is (differently!) in two
       %   locations as .o file
-      assert(size(IR,1) == 48 && size(IR,2) == 64);
-      
-      if ~exist('qdct_saliency_48_64','file')
+      % qdct_saliency takes any image size; the prebuilt (older)
+      % qdct_saliency_48_64 only takes 48x64 images, but does not have to be
+      % compiled
+      is_48_64 = (size(IR,1) == 48 && size(IR,2) == 64);
+      if exist('qdct_saliency','file') ~= 3
         addpath(genpath('qdct_impl')); % add the path to the implementation
-        if ~exist('qdct_saliency_48_64','file')
-          fprintf('Can not find qdct_saliency_48_64 .mex-file. Trying to compile.');
-          run('qdct_impl/build.m'); % compile/build the hard-coded interface
+        if exist('qdct_saliency','file') ~= 3 && ~(is_48_64 && exist('qdct_saliency_48_64','file') == 3)
+          fprintf('Can not find qdct_saliency .mex-file. Trying to compile.');
+          run('qdct_impl/build.m'); % compile/build the interfaces
         end
         addpath(genpath('qdct_impl')); % add the path to the implementation
         % check for success
-        if ~exist('qdct_saliency_48_64','file')
-          error('Can not find/build qdct_saliency_48_64');
+        if exist('qdct_saliency','file') ~= 3 && ~(is_48_64 && exist('qdct_saliency_48_64','file') == 3)
+          error('Can not find/build qdct_saliency');
         end
       end
       
+      if ~isfloat(IR)
+        IR=im2double(IR);
+      end
+      
       %tic
-      S=qdct_saliency_48_64(IR);
+      if exist('qdct_saliency','file') == 3
+        S=qdct_saliency(IR); % DCTs planned for size(IR), e.g. 48x64 uses the hard-coded codelets
+      else
+        S=qdct_saliency_48_64(double(IR));
+      end
       %toc
       
       if ~isempty(smap_smoothing_filter_params)